@@ -0,0 +1,70 @@
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+#include <xf/sync/Barrier.hpp>
+#include <xf/task/StaticTask.hpp>
+#include <xf/time/CycleClock.hpp>
+
+// Compares `Barrier` against an `xEventGroupSync` barrier, measuring how long a round takes when three tasks (two workers and `app_main`) meet at the barrier over and over.
+
+constexpr int ROUNDS = 10000;
+constexpr uint32_t PARTIES = 3;
+
+// Thin adapters so that both barriers can be driven by the same code.
+struct LightBarrier {
+    void arrive(uint32_t) { (void)barrier.await_arrive_and_wait(); }
+
+    xf::sync::Barrier barrier { PARTIES };
+};
+
+struct KernelBarrier {
+    static constexpr EventBits_t EVERYONE = (1 << PARTIES) - 1;
+
+    KernelBarrier() { handle = xEventGroupCreateStatic(&buffer); }
+
+    void arrive(uint32_t index) { (void)xEventGroupSync(handle, 1 << index, EVERYONE, portMAX_DELAY); }
+
+    StaticEventGroup_t buffer;
+    EventGroupHandle_t handle;
+};
+
+template<typename B>
+class Worker : public xf::task::StaticTask<4096> {
+    void run() override {
+        for (int i = 0; i < ROUNDS; ++i)
+            m_barrier.arrive(m_index);
+    }
+
+public:
+    Worker(B& barrier, uint32_t index)
+        : m_barrier(barrier)
+        , m_index(index) { }
+
+private:
+    B& m_barrier;
+    uint32_t m_index;
+};
+
+template<typename B>
+xf::time::CycleClock::duration rounds(B& barrier) {
+    static Worker<B> first { barrier, 1 };
+    static Worker<B> second { barrier, 2 };
+    first.create(10);
+    second.create(10);
+
+    xf::time::Timing timing;
+    for (int i = 0; i < ROUNDS; ++i) {
+        const auto start = xf::time::CycleClock::now();
+        barrier.arrive(0);
+        timing.record(xf::time::CycleClock::now() - start);
+    }
+    return timing.average();
+}
+
+extern "C" void app_main() {
+    static LightBarrier light;
+    static KernelBarrier kernel;
+
+    ESP_LOGI("Barrier", "light=%lu cycles/round", (unsigned long)rounds(light).count());
+    ESP_LOGI("Barrier", "kernel=%lu cycles/round", (unsigned long)rounds(kernel).count());
+}
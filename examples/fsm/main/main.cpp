@@ -0,0 +1,93 @@
+#include <esp_log.h>
+#include <xf/fsm/Machine.hpp>
+#include <xf/queue/StaticQueue.hpp>
+#include <xf/task/StaticTask.hpp>
+
+using namespace std::chrono_literals;
+
+// The states of a door. `Count` must always be the last enumerator.
+enum class Door {
+    Closed,
+    Open,
+    Opening,
+    Holding,
+    Count,
+};
+
+enum class DoorEvent {
+    Button,
+    Obstacle,
+    Timeout,
+    Count,
+};
+
+class Doors;
+
+using DoorMachine = xf::fsm::Machine<Door, DoorEvent, Doors>;
+
+// The transition table is built at compile time and lives in flash.
+// `Opening` and `Holding` are nested in `Open`, so both inherit it's `Obstacle` transition.
+static constexpr DoorMachine::Table DOOR_TABLE {
+    {
+        { .state = Door::Closed, .on_entry = [](Doors&) { ESP_LOGI("Door", "Closed"); } },
+        { .state = Door::Open, .on_exit = [](Doors&) { ESP_LOGI("Door", "Closing"); } },
+        { .state = Door::Opening, .parent = Door::Open, .timeout = 2s, .timeout_event = DoorEvent::Timeout },
+        { .state = Door::Holding, .parent = Door::Open, .timeout = 5s, .timeout_event = DoorEvent::Timeout },
+    },
+    {
+        { Door::Closed, DoorEvent::Button, Door::Opening },
+        { Door::Opening, DoorEvent::Timeout, Door::Holding },
+        { Door::Holding, DoorEvent::Timeout, Door::Closed },
+        // Restart the hold period.
+        { Door::Holding, DoorEvent::Button, Door::Holding },
+        { Door::Open, DoorEvent::Obstacle, Door::Opening, [](Doors&) { ESP_LOGW("Door", "Obstacle detected"); } },
+    },
+};
+
+// A single task hosting two independent doors.
+// Without the state machine framework this would usually be two tasks, each with it's own queue and timers.
+class Doors : public xf::task::StaticTask<4096> {
+    void setup() override;
+
+    void run() override;
+
+public:
+    using Inbox = xf::queue::StaticQueue<xf::fsm::Envelope, 8>;
+
+    Doors()
+        : m_front(DOOR_TABLE, Door::Closed, *this, m_inbox)
+        , m_back(DOOR_TABLE, Door::Closed, *this, m_inbox) { }
+
+    DoorMachine& front() { return m_front; }
+    DoorMachine& back() { return m_back; }
+
+private:
+    Inbox m_inbox;
+
+    DoorMachine m_front;
+    DoorMachine m_back;
+};
+
+void Doors::setup() {
+    m_inbox.create();
+
+    m_front.create("Front door");
+    m_back.create("Back door");
+}
+
+void Doors::run() {
+    xf::fsm::host(m_inbox);
+}
+
+extern "C" void app_main() {
+    static Doors doors;
+    doors.create("Doors", 5);
+
+    // Any task can post events to the machines.
+    while (true) {
+        doors.front().await_post(DoorEvent::Button);
+        vTaskDelay(pdMS_TO_TICKS(3000));
+        doors.back().await_post(DoorEvent::Button);
+        vTaskDelay(pdMS_TO_TICKS(10000));
+    }
+}
@@ -0,0 +1,80 @@
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <xf/sync/LightSemaphore.hpp>
+#include <xf/task/StaticTask.hpp>
+#include <xf/time/CycleClock.hpp>
+
+// Compares `LightSemaphore` against a kernel semaphore, both when nobody has to wait and when two tasks ping-pong a permit back and forth.
+
+constexpr int ROUNDS = 10000;
+
+// A thin adapter so that both semaphores can be driven by the same code.
+struct KernelSemaphore {
+    KernelSemaphore() { handle = xSemaphoreCreateBinaryStatic(&buffer); }
+
+    void await_take() { (void)xSemaphoreTake(handle, portMAX_DELAY); }
+    bool try_take() { return xSemaphoreTake(handle, 0) == pdTRUE; }
+    void give() { (void)xSemaphoreGive(handle); }
+
+    StaticSemaphore_t buffer;
+    SemaphoreHandle_t handle;
+};
+
+template<typename Semaphore>
+xf::time::CycleClock::duration uncontended(Semaphore& semaphore) {
+    xf::time::Timing timing;
+    for (int i = 0; i < ROUNDS; ++i) {
+        const auto start = xf::time::CycleClock::now();
+        semaphore.give();
+        (void)semaphore.try_take();
+        timing.record(xf::time::CycleClock::now() - start);
+    }
+    return timing.average();
+}
+
+// Echoes every permit it takes from `ping` back through `pong`.
+template<typename Semaphore>
+class Echo : public xf::task::StaticTask<4096> {
+    void run() override {
+        while (true) {
+            m_ping.await_take();
+            m_pong.give();
+        }
+    }
+
+public:
+    Echo(Semaphore& ping, Semaphore& pong)
+        : m_ping(ping)
+        , m_pong(pong) { }
+
+private:
+    Semaphore& m_ping;
+    Semaphore& m_pong;
+};
+
+template<typename Semaphore>
+xf::time::CycleClock::duration ping_pong(Semaphore& ping, Semaphore& pong) {
+    xf::time::Timing timing;
+    for (int i = 0; i < ROUNDS; ++i) {
+        const auto start = xf::time::CycleClock::now();
+        ping.give();
+        pong.await_take();
+        timing.record(xf::time::CycleClock::now() - start);
+    }
+    return timing.average();
+}
+
+extern "C" void app_main() {
+    static xf::sync::LightSemaphore light_ping, light_pong;
+    static KernelSemaphore kernel_ping, kernel_pong;
+    static Echo<xf::sync::LightSemaphore> light_echo { light_ping, light_pong };
+    static Echo<KernelSemaphore> kernel_echo { kernel_ping, kernel_pong };
+
+    ESP_LOGI("Uncontended", "light=%lu cycles, kernel=%lu cycles", (unsigned long)uncontended(light_ping).count(), (unsigned long)uncontended(kernel_ping).count());
+
+    light_echo.create("Light echo", 10);
+    kernel_echo.create("Kernel echo", 10);
+
+    ESP_LOGI("Ping-pong", "light=%lu cycles, kernel=%lu cycles", (unsigned long)ping_pong(light_ping, light_pong).count(), (unsigned long)ping_pong(kernel_ping, kernel_pong).count());
+}
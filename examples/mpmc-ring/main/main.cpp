@@ -0,0 +1,79 @@
+#include <atomic>
+
+#include <esp_log.h>
+#include <xf/queue/MpmcRing.hpp>
+#include <xf/queue/StaticQueue.hpp>
+#include <xf/task/StaticTask.hpp>
+#include <xf/time/time.hpp>
+
+// Measures how long 2 producers and 2 consumers, one of each pinned to every core, take to pass `ITEMS` items through an `MpmcRing` and through a `StaticQueue`.
+
+constexpr uint32_t ITEMS = 100'000;
+constexpr size_t LENGTH = 64;
+
+// A thin adapter so that both queues can be driven by the same code.
+struct KernelQueue : xf::queue::StaticQueue<uint32_t, LENGTH> {
+    KernelQueue() { create(); }
+};
+
+template<typename Queue>
+class Producer : public xf::task::StaticTask<4096> {
+    void run() override {
+        for (uint32_t i = 0; i < ITEMS / 2; ++i)
+            m_queue.await_send(i);
+        vTaskSuspend(nullptr);
+    }
+
+public:
+    explicit Producer(Queue& queue)
+        : m_queue(queue) { }
+
+private:
+    Queue& m_queue;
+};
+
+template<typename Queue>
+class Consumer : public xf::task::StaticTask<4096> {
+    void run() override {
+        for (uint32_t i = 0; i < ITEMS / 2; ++i)
+            (void)m_queue.await_receive();
+        m_done.fetch_add(1);
+        vTaskSuspend(nullptr);
+    }
+
+public:
+    Consumer(Queue& queue, std::atomic<int>& done)
+        : m_queue(queue)
+        , m_done(done) { }
+
+private:
+    Queue& m_queue;
+    std::atomic<int>& m_done;
+};
+
+template<typename Queue>
+xf::time::Duration contend(Queue& queue) {
+    static std::atomic<int> done { 0 };
+    static Producer<Queue> producers[] { Producer<Queue> { queue }, Producer<Queue> { queue } };
+    static Consumer<Queue> consumers[] { Consumer<Queue> { queue, done }, Consumer<Queue> { queue, done } };
+
+    const auto start = xf::time::Clock::now();
+    for (BaseType_t core = 0; core < 2; ++core) {
+        consumers[core].create_pinned_to_core("Consumer", 5, core);
+        producers[core].create_pinned_to_core("Producer", 5, core);
+    }
+    while (done.load() < 2)
+        vTaskDelay(1);
+
+    return xf::time::Clock::now() - start;
+}
+
+extern "C" void app_main() {
+    static xf::queue::MpmcRing<uint32_t, LENGTH> ring;
+    static KernelQueue queue;
+
+    const auto ring_time = std::chrono::duration_cast<xf::time::Milliseconds>(contend(ring));
+    const auto queue_time = std::chrono::duration_cast<xf::time::Milliseconds>(contend(queue));
+
+    ESP_LOGI("Contention", "%lu items: MpmcRing=%lums, StaticQueue=%lums", (unsigned long)ITEMS, (unsigned long)ring_time.count(), (unsigned long)queue_time.count());
+}
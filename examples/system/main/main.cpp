@@ -0,0 +1,77 @@
+#include <esp_log.h>
+#include <xf/queue/StaticQueue.hpp>
+#include <xf/system/System.hpp>
+#include <xf/task/StaticTask.hpp>
+
+using QueueA = xf::queue::StaticQueue<float, 5>;
+using QueueB = xf::queue::StaticQueue<int, 5>;
+
+// TaskA and TaskB are tightly coupled via circular queue communication, just like in the `maestro` example.
+// Here the queues are owned by the `System` instead, which constructs them before any task so each task can simply take references to the queues it talks to.
+class TaskA : public xf::task::StaticTask<4096> {
+    void run() override;
+
+public:
+    static constexpr const char* NAME = "Task A";
+
+    TaskA(QueueA& queue, QueueB& task_b_queue)
+        : m_queue(queue)
+        , m_task_b_queue(task_b_queue) { }
+
+private:
+    QueueA& m_queue;        // Receives float events from TaskB
+    QueueB& m_task_b_queue; // Sends int events to TaskB
+};
+
+void TaskA::run() {
+    while (true) {
+        auto _ = m_queue.await_receive(); // Wait for float from TaskB
+        m_task_b_queue.await_send(47);    // Respond with int to TaskB
+    }
+}
+
+class TaskB : public xf::task::StaticTask<4096> {
+    void run() override;
+
+public:
+    static constexpr const char* NAME = "Task B";
+
+    TaskB(QueueB& queue, QueueA& task_a_queue)
+        : m_queue(queue)
+        , m_task_a_queue(task_a_queue) { }
+
+private:
+    QueueB& m_queue;        // Receives int from TaskA
+    QueueA& m_task_a_queue; // Sends float to TaskA
+};
+
+void TaskB::run() {
+    ESP_LOGI("Task B", "Kicking things off");
+    m_task_a_queue.await_send(55.0f);
+
+    while (true) {
+        auto _ = m_queue.await_receive(); // Wait for int from TaskA
+        m_task_a_queue.await_send(55.0f); // Respond with float to TaskA
+    }
+}
+
+// The entries of the system, which describe every object we want to own.
+using QueueAEntry = xf::system::Queue<QueueA>;
+using QueueBEntry = xf::system::Queue<QueueB>;
+using TaskAEntry = xf::system::Task<TaskA, 5, xf::system::Connect<QueueAEntry, QueueBEntry>>;
+using TaskBEntry = xf::system::Task<TaskB, 5, xf::system::Connect<QueueBEntry, QueueAEntry>>;
+
+// The whole firmware, checked at compile-time to fit in 16KiB of RAM.
+using System = xf::system::System<
+    xf::system::Queues<QueueAEntry, QueueBEntry>,
+    xf::system::Tasks<TaskAEntry, TaskBEntry>,
+    16 * 1024>;
+
+extern "C" void app_main() {
+    static System system;
+
+    ESP_LOGI("System", "Creating the system (%zu bytes)", System::RAM);
+
+    // Queues first, then tasks - none of which will run until everything has been created.
+    system.create();
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdio>
+#include <string_view>
+#include <type_traits>
+
+namespace xf {
+
+/// A string holding up to `CAPACITY` characters inline, always null-terminated.
+/// Unlike `std::string` it never allocates and is trivially copyable, so it goes through the direct copy path of `Queue` and can be sent through an `isr::Queue`.
+/// Operations that would exceed the capacity truncate the string and report it instead of failing.
+template<size_t CAPACITY>
+class FixedString {
+public:
+    /// Constructs an empty string.
+    constexpr FixedString() = default;
+
+    /// Constructs a string holding the given characters, truncated to `CAPACITY`.
+    constexpr FixedString(std::string_view string) { (void)append(string); }
+
+    /// Constructs a string holding the given null-terminated characters, truncated to `CAPACITY`.
+    constexpr FixedString(const char* string)
+        : FixedString(std::string_view { string }) { }
+
+    /// Constructs a string from a `printf`-style format, truncated to `CAPACITY`.
+    [[nodiscard]] static FixedString format(const char* format, ...) __attribute__((format(printf, 1, 2)));
+
+    /// Appends the characters to the end of the string and returns whether all of them fit.
+    constexpr bool append(std::string_view string);
+
+    /// Appends a `printf`-style format to the end of the string and returns whether all of it fit.
+    bool append_format(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+    /// Appends a character to the end of the string and returns whether it fit.
+    constexpr bool push_back(char character) { return append(std::string_view { &character, 1 }); }
+
+    /// Removes the last character of the string, which must not be empty.
+    constexpr void pop_back() { m_data[--m_size] = '\0'; }
+
+    /// Removes every character of the string.
+    constexpr void clear() {
+        m_size = 0;
+        m_data[0] = '\0';
+    }
+
+    [[nodiscard]] constexpr size_t size() const { return m_size; }
+    [[nodiscard]] static constexpr size_t capacity() { return CAPACITY; }
+    [[nodiscard]] constexpr bool empty() const { return m_size == 0; }
+    [[nodiscard]] constexpr bool full() const { return m_size == CAPACITY; }
+
+    [[nodiscard]] constexpr const char* c_str() const { return m_data.data(); }
+    [[nodiscard]] constexpr const char* data() const { return m_data.data(); }
+    [[nodiscard]] constexpr char* data() { return m_data.data(); }
+
+    [[nodiscard]] constexpr std::string_view view() const { return { m_data.data(), m_size }; }
+    constexpr operator std::string_view() const { return view(); }
+
+    [[nodiscard]] constexpr char& operator[](size_t index) { return m_data[index]; }
+    [[nodiscard]] constexpr char operator[](size_t index) const { return m_data[index]; }
+
+    [[nodiscard]] constexpr char* begin() { return m_data.data(); }
+    [[nodiscard]] constexpr char* end() { return m_data.data() + m_size; }
+    [[nodiscard]] constexpr const char* begin() const { return m_data.data(); }
+    [[nodiscard]] constexpr const char* end() const { return m_data.data() + m_size; }
+
+    template<size_t OTHER_CAPACITY>
+    [[nodiscard]] constexpr bool operator==(const FixedString<OTHER_CAPACITY>& other) const { return view() == other.view(); }
+    [[nodiscard]] constexpr bool operator==(std::string_view other) const { return view() == other; }
+
+private:
+    bool vappend_format(const char* format, va_list arguments);
+
+    std::array<char, CAPACITY + 1> m_data {};
+    size_t m_size { 0 };
+};
+
+template<size_t CAPACITY>
+FixedString<CAPACITY> FixedString<CAPACITY>::format(const char* format, ...) {
+    FixedString string;
+    va_list arguments;
+    va_start(arguments, format);
+    (void)string.vappend_format(format, arguments);
+    va_end(arguments);
+    return string;
+}
+
+template<size_t CAPACITY>
+constexpr bool FixedString<CAPACITY>::append(std::string_view string) {
+    const size_t length = std::min(string.size(), CAPACITY - m_size);
+    std::copy_n(string.data(), length, m_data.data() + m_size);
+    m_size += length;
+    m_data[m_size] = '\0';
+    return length == string.size();
+}
+
+template<size_t CAPACITY>
+bool FixedString<CAPACITY>::append_format(const char* format, ...) {
+    va_list arguments;
+    va_start(arguments, format);
+    const bool fit = vappend_format(format, arguments);
+    va_end(arguments);
+    return fit;
+}
+
+template<size_t CAPACITY>
+bool FixedString<CAPACITY>::vappend_format(const char* format, va_list arguments) {
+    const int written = std::vsnprintf(m_data.data() + m_size, CAPACITY - m_size + 1, format, arguments);
+    if (written < 0) {
+        m_data[m_size] = '\0';
+        return false;
+    }
+
+    const size_t wanted = m_size + static_cast<size_t>(written);
+    m_size = std::min(wanted, CAPACITY);
+    return wanted <= CAPACITY;
+}
+
+static_assert(std::is_trivially_copyable_v<FixedString<8>>);
+
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include <freertos/FreeRTOS.h>
+
+namespace xf {
+
+/// A vector holding up to `CAPACITY` items inline, without ever allocating.
+/// It is trivially copyable whenever `T` is, so vectors of trivially copyable items go through the direct copy path of `Queue` and can be sent through an `isr::Queue`.
+/// Items are only constructed when they are added, so `T` doesn't need to be default constructible.
+template<typename T, size_t CAPACITY>
+class StaticVector {
+public:
+    static_assert(CAPACITY > 0, "Static vector capacity must be at least 1");
+
+    /// Constructs an empty vector.
+    StaticVector() = default;
+
+    /// Constructs a vector holding the given items, which must not be more than `CAPACITY`.
+    StaticVector(std::initializer_list<T> items) {
+        configASSERT(items.size() <= CAPACITY);
+        for (const auto& item : items)
+            (void)push_back(item);
+    }
+
+    StaticVector(const StaticVector&)
+        requires std::is_trivially_copy_constructible_v<T>
+    = default;
+    StaticVector(const StaticVector& other) { copy_from(other); }
+
+    StaticVector(StaticVector&&)
+        requires std::is_trivially_move_constructible_v<T>
+    = default;
+    StaticVector(StaticVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) { move_from(other); }
+
+    StaticVector& operator=(const StaticVector&)
+        requires std::is_trivially_copy_assignable_v<T> and std::is_trivially_destructible_v<T>
+    = default;
+    StaticVector& operator=(const StaticVector& other) {
+        if (this != &other) {
+            clear();
+            copy_from(other);
+        }
+        return *this;
+    }
+
+    StaticVector& operator=(StaticVector&&)
+        requires std::is_trivially_move_assignable_v<T> and std::is_trivially_destructible_v<T>
+    = default;
+    StaticVector& operator=(StaticVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this != &other) {
+            clear();
+            move_from(other);
+        }
+        return *this;
+    }
+
+    ~StaticVector()
+        requires std::is_trivially_destructible_v<T>
+    = default;
+    ~StaticVector() { clear(); }
+
+    /// Copies the item to the back of the vector and returns whether there was room for it.
+    [[nodiscard]] bool push_back(const T& item) { return emplace_back(item) != nullptr; }
+
+    /// Moves the item to the back of the vector and returns whether there was room for it.
+    [[nodiscard]] bool push_back(T&& item) { return emplace_back(std::move(item)) != nullptr; }
+
+    /// Constructs an item at the back of the vector from the given arguments and returns it, or `nullptr` if there was no room for it.
+    template<typename... Args>
+    T* emplace_back(Args&&... args) {
+        if (full())
+            return nullptr;
+        return std::construct_at(data() + m_size++, std::forward<Args>(args)...);
+    }
+
+    /// Destroys the last item of the vector, which must not be empty.
+    void pop_back() {
+        configASSERT(m_size > 0);
+        std::destroy_at(data() + --m_size);
+    }
+
+    /// Removes the item at the given index, shifting the items behind it forward.
+    void erase(size_t index) {
+        configASSERT(index < m_size);
+        std::move(begin() + index + 1, end(), begin() + index);
+        pop_back();
+    }
+
+    /// Destroys every item of the vector.
+    void clear() {
+        std::destroy(begin(), end());
+        m_size = 0;
+    }
+
+    [[nodiscard]] size_t size() const { return m_size; }
+    [[nodiscard]] static constexpr size_t capacity() { return CAPACITY; }
+    [[nodiscard]] bool empty() const { return m_size == 0; }
+    [[nodiscard]] bool full() const { return m_size == CAPACITY; }
+
+    [[nodiscard]] T* data() { return std::launder(reinterpret_cast<T*>(m_storage)); }
+    [[nodiscard]] const T* data() const { return std::launder(reinterpret_cast<const T*>(m_storage)); }
+
+    [[nodiscard]] T& operator[](size_t index) { return data()[index]; }
+    [[nodiscard]] const T& operator[](size_t index) const { return data()[index]; }
+
+    [[nodiscard]] T& front() { return data()[0]; }
+    [[nodiscard]] const T& front() const { return data()[0]; }
+    [[nodiscard]] T& back() { return data()[m_size - 1]; }
+    [[nodiscard]] const T& back() const { return data()[m_size - 1]; }
+
+    [[nodiscard]] T* begin() { return data(); }
+    [[nodiscard]] T* end() { return data() + m_size; }
+    [[nodiscard]] const T* begin() const { return data(); }
+    [[nodiscard]] const T* end() const { return data() + m_size; }
+
+    operator std::span<T>() { return { data(), m_size }; }
+    operator std::span<const T>() const { return { data(), m_size }; }
+
+private:
+    void copy_from(const StaticVector& other) {
+        for (const auto& item : other)
+            (void)emplace_back(item);
+    }
+
+    void move_from(StaticVector& other) {
+        for (auto& item : other)
+            (void)emplace_back(std::move(item));
+        other.clear();
+    }
+
+    alignas(T) std::byte m_storage[CAPACITY * sizeof(T)];
+    size_t m_size { 0 };
+};
+
+}
@@ -0,0 +1,57 @@
+#include "Actor.hpp"
+
+namespace xf::actor {
+
+Metrics ActorBase::metrics() const {
+    return {
+        .received = m_received.load(std::memory_order_relaxed),
+        .dropped = m_dropped.load(std::memory_order_relaxed),
+        .processed = m_processed.load(std::memory_order_relaxed),
+        .turns = m_turns.load(std::memory_order_relaxed),
+        .mailbox_high_watermark = m_mailbox_high_watermark.load(std::memory_order_relaxed),
+    };
+}
+
+BaseType_t ActorBase::core() const {
+    return m_core;
+}
+
+void ActorBase::serve(queue::Queue<ActorBase*>& ready, size_t budget) {
+    while (true) {
+        auto* actor = ready.await_receive();
+
+        const auto handled = actor->drain(budget);
+        actor->m_processed.fetch_add(handled, std::memory_order_relaxed);
+        actor->m_turns.fetch_add(1, std::memory_order_relaxed);
+
+        // Out of budget, go to the back of the line.
+        if (actor->has_messages()) {
+            ready.await_send(actor);
+            continue;
+        }
+
+        // A message may have arrived right before the flag was cleared, in which case it's sender didn't schedule the actor.
+        actor->m_scheduled.store(false);
+        if (actor->has_messages() and not actor->m_scheduled.exchange(true))
+            ready.await_send(actor);
+    }
+}
+
+void ActorBase::wake() {
+    configASSERT(m_scheduler);
+    if (not m_scheduled.exchange(true))
+        m_scheduler->schedule(*this);
+}
+
+void ActorBase::record_received(size_t pending) {
+    m_received.fetch_add(1, std::memory_order_relaxed);
+
+    auto high_watermark = m_mailbox_high_watermark.load(std::memory_order_relaxed);
+    while (pending > high_watermark and not m_mailbox_high_watermark.compare_exchange_weak(high_watermark, pending, std::memory_order_relaxed)) { }
+}
+
+void ActorBase::record_dropped() {
+    m_dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+}
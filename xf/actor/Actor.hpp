@@ -0,0 +1,189 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include <freertos/FreeRTOS.h>
+
+#include <xf/queue/Queue.hpp>
+#include <xf/sync/CriticalSection.hpp>
+
+namespace xf::actor {
+
+class ActorBase;
+
+/// The interface through which actors with pending messages are handed over to the workers of a runtime.
+class Scheduler {
+public:
+    /// Queues the actor to be run by one of the workers of it's core.
+    virtual void schedule(ActorBase&) = 0;
+
+protected:
+    ~Scheduler() = default;
+};
+
+/// Counters describing the activity of an actor.
+struct Metrics {
+    /// Messages accepted into the mailbox.
+    uint32_t received;
+    /// Messages rejected because the mailbox was full.
+    uint32_t dropped;
+    /// Messages handled by the actor.
+    uint32_t processed;
+    /// Number of times the actor was run by a worker.
+    uint32_t turns;
+    /// The largest number of messages that were waiting in the mailbox at once.
+    uint32_t mailbox_high_watermark;
+};
+
+/// The type-independent part of an `Actor`, which is what the runtime and it's workers operate on.
+/// Refer to `Actor`'s documentation for more information.
+class ActorBase {
+public:
+    virtual ~ActorBase() = default;
+
+    // Actors are referred to by address by the runtime, so they must stay in place.
+    ActorBase(ActorBase&&) = delete;
+    ActorBase& operator=(ActorBase&&) = delete;
+    ActorBase(const ActorBase&) = delete;
+    ActorBase& operator=(const ActorBase&) = delete;
+
+    /// Obtains a snapshot of the actor's counters.
+    [[nodiscard]] Metrics metrics() const;
+
+    /// Obtains the core whose workers run this actor.
+    [[nodiscard]] BaseType_t core() const;
+
+    /// Waits indefinitely for an actor to be ready and then runs it for up to `budget` messages, forever.
+    /// Actors that still have pending messages after their turn are sent to the back of `ready`, so that every actor gets a fair share of the worker.
+    /// This is the main loop of every runtime worker.
+    static void serve(queue::Queue<ActorBase*>& ready, size_t budget);
+
+protected:
+    ActorBase() = default;
+
+    /// Hands the actor over to it's scheduler, unless it is already waiting to be run or running.
+    /// Must be called after a message is added to the mailbox.
+    void wake();
+
+    /// Records a message that was accepted into a mailbox that now holds `pending` messages.
+    void record_received(size_t pending);
+
+    /// Records a message that was rejected because the mailbox was full.
+    void record_dropped();
+
+private:
+    template<size_t, size_t, size_t>
+    friend class Runtime;
+
+    /// Handles up to `budget` messages, returning how many were handled.
+    virtual size_t drain(size_t budget) = 0;
+
+    /// Returns whether the mailbox has pending messages.
+    virtual bool has_messages() = 0;
+
+    Scheduler* m_scheduler { nullptr };
+    BaseType_t m_core { 0 };
+
+    // Whether the actor is either waiting in a ready queue or being run by a worker, which guarantees it is only ever run by a single worker at a time.
+    std::atomic<bool> m_scheduled { false };
+
+    std::atomic<uint32_t> m_received { 0 };
+    std::atomic<uint32_t> m_dropped { 0 };
+    std::atomic<uint32_t> m_processed { 0 };
+    std::atomic<uint32_t> m_turns { 0 };
+    std::atomic<uint32_t> m_mailbox_high_watermark { 0 };
+};
+
+/// A lightweight unit of concurrency that processes `Message`s sent to it one at a time, without owning a task.
+/// Messages are stored in a bounded, statically allocated mailbox holding up to `CAPACITY` messages. Whenever an actor has pending messages it is scheduled onto one of the workers of the `Runtime` it was spawned on, which calls `handle()` for each message.
+/// Since messages are copied in and out of the mailbox inside a critical section they must be trivially copyable, see `Queue` if that's a problem.
+/// Declaring your own actors is accomplished by deriving from this class and implementing the `handle()` method.
+template<typename Message, size_t CAPACITY>
+class Actor : public ActorBase {
+public:
+    static_assert(std::is_trivially_copyable_v<Message>, "Messages must be trivially copyable so that they can be copied inside a critical section.");
+    static_assert(CAPACITY > 0, "Mailbox capacity must be at least 1");
+
+    /// Tries adding the message to the mailbox and returns whether it was successful, which only fails if the mailbox is full.
+    /// Never blocks. Must only be called from a task.
+    [[nodiscard]] bool send(const Message&);
+
+    /// Obtains the number of messages waiting in the mailbox.
+    [[nodiscard]] size_t messages_waiting();
+
+protected:
+    /// The user-defined function that will be called for each message, from one of the runtime's workers.
+    virtual void handle(const Message&) = 0;
+
+private:
+    size_t drain(size_t budget) override;
+    bool has_messages() override;
+
+    sync::CriticalSection m_lock;
+
+    alignas(Message) std::array<std::byte, CAPACITY * sizeof(Message)> m_mailbox;
+    size_t m_head { 0 };
+    size_t m_count { 0 };
+};
+
+template<typename Message, size_t CAPACITY>
+bool Actor<Message, CAPACITY>::send(const Message& message) {
+    const size_t pending = m_lock.locked([&]() -> size_t {
+        if (m_count == CAPACITY)
+            return 0;
+
+        std::memcpy(&m_mailbox[((m_head + m_count) % CAPACITY) * sizeof(Message)], &message, sizeof(Message));
+        return ++m_count;
+    });
+
+    if (pending == 0) {
+        record_dropped();
+        return false;
+    }
+
+    record_received(pending);
+    wake();
+    return true;
+}
+
+template<typename Message, size_t CAPACITY>
+size_t Actor<Message, CAPACITY>::messages_waiting() {
+    return m_lock.locked([&] { return m_count; });
+}
+
+template<typename Message, size_t CAPACITY>
+size_t Actor<Message, CAPACITY>::drain(size_t budget) {
+    size_t handled = 0;
+    for (; handled < budget; ++handled) {
+        alignas(Message) std::byte buffer[sizeof(Message)];
+
+        const bool popped = m_lock.locked([&] {
+            if (m_count == 0)
+                return false;
+
+            std::memcpy(buffer, &m_mailbox[m_head * sizeof(Message)], sizeof(Message));
+            m_head = (m_head + 1) % CAPACITY;
+            --m_count;
+            return true;
+        });
+        if (not popped)
+            break;
+
+        // The message is handled outside of the critical section, allowing new messages to arrive in the meantime.
+        handle(std::bit_cast<Message>(buffer));
+    }
+    return handled;
+}
+
+template<typename Message, size_t CAPACITY>
+bool Actor<Message, CAPACITY>::has_messages() {
+    return messages_waiting() > 0;
+}
+
+}
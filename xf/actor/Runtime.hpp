@@ -0,0 +1,122 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+#include <freertos/FreeRTOS.h>
+
+#include "Actor.hpp"
+#include <xf/queue/StaticQueue.hpp>
+#include <xf/task/StaticTask.hpp>
+#include <xf/time/time.hpp>
+
+namespace xf::actor {
+
+/// Runs any number of actors on a fixed pool of `WORKERS` statically allocated tasks, each with a stack depth of `STACK_DEPTH`.
+/// Every actor is bound to a single core for it's whole life, which keeps it's state warm in that core's cache. Each core has a queue of ready actors (those with pending messages) that is served by the workers pinned to it.
+/// To keep one busy actor from starving the others, a worker handles at most `budget` messages of an actor before moving it to the back of the queue.
+/// Up to `MAX_ACTORS` actors can be spawned on a runtime.
+template<size_t WORKERS, size_t MAX_ACTORS = 64, size_t STACK_DEPTH = 4096>
+class Runtime : private Scheduler {
+public:
+    static_assert(WORKERS > 0, "A runtime needs at least one worker");
+
+#if ESP_PLATFORM
+    /// The number of cores actors are distributed across.
+    static constexpr size_t CORES = std::min<size_t>(WORKERS, portNUM_PROCESSORS);
+#else
+    /// The number of cores actors are distributed across.
+    static constexpr size_t CORES = 1;
+#endif
+
+    /// Constructs a new runtime where each actor handles at most `budget` messages per turn.
+    /// The runtime is not yet valid and must be made so by calling the `create()` function before being used.
+    explicit Runtime(size_t budget = 8);
+
+    // Actors and workers refer to the runtime by address, so it must stay in place.
+    Runtime(Runtime&&) = delete;
+    Runtime& operator=(Runtime&&) = delete;
+    Runtime(const Runtime&) = delete;
+    Runtime& operator=(const Runtime&) = delete;
+
+    /// Creates the ready queues and the workers, which run at the given priority.
+    /// Workers are pinned to the cores in a round-robin fashion.
+    void create(UBaseType_t priority);
+
+    /// Binds the actor to the runtime, assigning it to the core with the least actors.
+    /// Actors must be spawned before any message is sent to them.
+    void spawn(ActorBase&);
+
+    /// Binds the actor to the runtime, assigning it to the given core.
+    /// Actors must be spawned before any message is sent to them.
+    void spawn(ActorBase&, BaseType_t core);
+
+private:
+    void schedule(ActorBase&) override;
+
+    class Worker : public task::StaticTask<STACK_DEPTH> {
+        void run() override { ActorBase::serve(*ready, budget); }
+
+    public:
+        queue::Queue<ActorBase*>* ready { nullptr };
+        size_t budget { 0 };
+    };
+
+    // Each actor is in at most one ready queue at a time, so they can never overflow.
+    std::array<queue::StaticQueue<ActorBase*, MAX_ACTORS>, CORES> m_ready;
+    std::array<size_t, CORES> m_actors_per_core {};
+    size_t m_actors { 0 };
+
+    std::array<Worker, WORKERS> m_workers;
+};
+
+template<size_t WORKERS, size_t MAX_ACTORS, size_t STACK_DEPTH>
+Runtime<WORKERS, MAX_ACTORS, STACK_DEPTH>::Runtime(size_t budget) {
+    configASSERT(budget > 0);
+    for (size_t i = 0; i < WORKERS; ++i) {
+        m_workers[i].ready = &m_ready[i % CORES];
+        m_workers[i].budget = budget;
+    }
+}
+
+template<size_t WORKERS, size_t MAX_ACTORS, size_t STACK_DEPTH>
+void Runtime<WORKERS, MAX_ACTORS, STACK_DEPTH>::create(UBaseType_t priority) {
+    for (auto& ready : m_ready)
+        ready.create();
+
+    for (size_t i = 0; i < WORKERS; ++i) {
+#if ESP_PLATFORM
+        m_workers[i].create_pinned_to_core("xf::actor", priority, static_cast<BaseType_t>(i % CORES));
+#else
+        m_workers[i].create("xf::actor", priority);
+#endif
+    }
+}
+
+template<size_t WORKERS, size_t MAX_ACTORS, size_t STACK_DEPTH>
+void Runtime<WORKERS, MAX_ACTORS, STACK_DEPTH>::spawn(ActorBase& actor) {
+    const auto least_busy = std::min_element(m_actors_per_core.begin(), m_actors_per_core.end());
+    spawn(actor, static_cast<BaseType_t>(least_busy - m_actors_per_core.begin()));
+}
+
+template<size_t WORKERS, size_t MAX_ACTORS, size_t STACK_DEPTH>
+void Runtime<WORKERS, MAX_ACTORS, STACK_DEPTH>::spawn(ActorBase& actor, BaseType_t core) {
+    configASSERT(actor.m_scheduler == nullptr);
+    configASSERT(core >= 0 and static_cast<size_t>(core) < CORES);
+    configASSERT(m_actors < MAX_ACTORS);
+
+    actor.m_scheduler = this;
+    actor.m_core = core;
+
+    ++m_actors;
+    ++m_actors_per_core[core];
+}
+
+template<size_t WORKERS, size_t MAX_ACTORS, size_t STACK_DEPTH>
+void Runtime<WORKERS, MAX_ACTORS, STACK_DEPTH>::schedule(ActorBase& actor) {
+    [[maybe_unused]] const bool sent = m_ready[actor.m_core].send(&actor, time::NO_WAIT);
+    configASSERT(sent);
+}
+
+}
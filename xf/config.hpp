@@ -0,0 +1,56 @@
+#pragma once
+
+#include <freertos/FreeRTOS.h>
+
+//! Compile-time configuration of xf.
+//! Every option can be overridden by defining it before this header is included, usually through the build system (e.g: `target_compile_definitions(${COMPONENT_LIB} PUBLIC XF_SYNC_NOTIFICATION_INDEX=2)`).
+
+/// The index of the task notification used by the `xf::sync` primitives to block and wake up tasks.
+/// Since a task can only ever be blocked on a single primitive at a time, one index is shared by all of them, but tasks using `xf::sync` must not use this index for anything else.
+/// In particular, the notifications declared by `Task` are numbered from index 0, so a task blocking on this index can declare at most `XF_SYNC_NOTIFICATION_INDEX` of them.
+/// Defaults to the last entry of the notification array. Everything that blocks on it - the `xf::sync` primitives, `MpmcRing`, `run_on_shared_stack()` and `Task::defer_start()` - asserts that it isn't the default index used by plain `xTaskNotify*()` calls and `EventLoop`, so using them requires `configTASK_NOTIFICATION_ARRAY_ENTRIES` to be at least 2.
+#ifndef XF_SYNC_NOTIFICATION_INDEX
+#    define XF_SYNC_NOTIFICATION_INDEX (configTASK_NOTIFICATION_ARRAY_ENTRIES - 1)
+#endif
+
+static_assert(XF_SYNC_NOTIFICATION_INDEX < configTASK_NOTIFICATION_ARRAY_ENTRIES, "`XF_SYNC_NOTIFICATION_INDEX` must be lower than `configTASK_NOTIFICATION_ARRAY_ENTRIES`");
+
+/// Whether ISRs measured with `xf::isr::Measured` record their execution time and stamp the tasks they wake up, so that the ISR-to-task latency can be recorded.
+/// Disabled by default, in which case the instrumentation compiles down to nothing.
+#ifndef XF_ISR_INSTRUMENTATION
+#    define XF_ISR_INSTRUMENTATION 0
+#endif
+
+/// Whether the FreeRTOS tick count is simulated, jumping forward whenever every task is blocked. Meant for tests only.
+/// Refer to `xf/time/Simulation.hpp` for how to wire it into `FreeRTOSConfig.h`.
+#ifndef XF_TIME_SIMULATION
+#    define XF_TIME_SIMULATION 0
+#endif
+
+/// The stack depth of the task behind `xf::task::run_on_shared_stack()`, which is shared by every caller.
+/// Like every other stack depth this is expressed in units of `StackType_t`. Defaults to 12 KiB.
+#ifndef XF_SHARED_STACK_DEPTH
+#    define XF_SHARED_STACK_DEPTH (12 * 1024 / sizeof(StackType_t))
+#endif
+
+/// Whether every `Queue` stores the `CycleClock` time at which each item was sent alongside it, and records how long items waited in the queue into a per-queue histogram, obtained through `QueueCore::dwell_time()`.
+/// Disabled by default, in which case queues store their items as-is.
+#ifndef XF_QUEUE_DWELL_TIME
+#    define XF_QUEUE_DWELL_TIME 0
+#endif
+
+/// Whether xf's blocking calls register what the calling task is waiting on, so that `xf::sync::wait_graph::analyze()` can build the wait-for graph and report deadlocks and priority inversions.
+/// Disabled by default, in which case the registration compiles down to nothing.
+#ifndef XF_WAIT_GRAPH
+#    define XF_WAIT_GRAPH 0
+#endif
+
+/// The maximum number of tasks the wait-for graph can track as blocked at the same time. Waits beyond it are counted, but not tracked.
+#ifndef XF_WAIT_GRAPH_TASKS
+#    define XF_WAIT_GRAPH_TASKS 16
+#endif
+
+/// The maximum number of queues and notifications the wait-for graph remembers the last sender and receiver of. The least recently added one is forgotten to make room for a new one.
+#ifndef XF_WAIT_GRAPH_RESOURCES
+#    define XF_WAIT_GRAPH_RESOURCES 32
+#endif
@@ -0,0 +1,385 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <type_traits>
+
+#include <xf/queue/Queue.hpp>
+#include <xf/time/time.hpp>
+#include <xf/timer/Timer.hpp>
+
+namespace xf::fsm {
+
+/// Restricts a template parameter to an enumeration whose last enumerator is `Count`, which is used to size the transition table.
+template<typename E>
+concept Enumeration = std::is_enum_v<E> and requires { E::Count; };
+
+/// An event addressed to a particular machine.
+/// Envelopes are small and trivially copyable, meaning they go through a `Queue` without any allocation, and carry everything needed to be delivered to their machine. This allows machines of different types to share a single `Inbox`, and therefore a single task.
+struct Envelope {
+    /// Hands the event over to the machine it is addressed to.
+    void deliver() const { handler(machine, event, epoch); }
+
+    void* machine;
+    void (*handler)(void* machine, uint32_t event, uint32_t epoch);
+    uint32_t event;
+    // Identifies the state entry that armed a timeout, allowing timeouts that fired after their state was exited to be dropped. Zero for regular events.
+    // Timeouts leave `event` unused, since the state that armed them is the current one whenever they are delivered.
+    uint32_t epoch;
+};
+
+/// The queue through which events reach their machines.
+using Inbox = queue::Queue<Envelope>;
+
+/// Receives envelopes from the inbox and delivers them to their machines, forever.
+/// Call this from the `run()` method of the task that hosts the machines.
+inline void host(Inbox& inbox) {
+    while (true)
+        inbox.await_receive().deliver();
+}
+
+namespace detail {
+
+// Deliberately not `constexpr`: calling it while building a table turns the misconfiguration into a compile-time error.
+void invalid_table(const char* reason);
+
+}
+
+/// A hierarchical state machine whose transition table is built at compile time.
+/// Events are dispatched in constant time by indexing the table with the current state and the event, with no virtual dispatch involved. Transitions not handled by a state are inherited from its parent, and entering/exiting states runs their entry/exit actions from/to the least common ancestor of the source and target states.
+/// States may declare a timeout, after which an event of the user's choosing is delivered to the machine. Every machine uses a single timer for all of its states, and since events are delivered through an `Inbox` any number of machines can be hosted by a single task. See `host()`.
+/// Actions receive the `Ctx` object given on construction, which usually is the task hosting the machine. Actions must not call `dispatch()`, use `post()` to have the machine react to an event after the current transition is done.
+template<Enumeration State, Enumeration Event, typename Ctx>
+class Machine {
+public:
+    static constexpr size_t STATE_COUNT = static_cast<size_t>(State::Count);
+    static constexpr size_t EVENT_COUNT = static_cast<size_t>(Event::Count);
+
+    using Action = void (*)(Ctx&);
+
+    /// Describes the behavior of a single state.
+    struct StateConfig {
+        State state;
+        /// The state this state is nested in, if any.
+        std::optional<State> parent = std::nullopt;
+        /// Runs whenever the state is entered.
+        Action on_entry = nullptr;
+        /// Runs whenever the state is exited.
+        Action on_exit = nullptr;
+        /// How long the machine can stay in this state before `timeout_event` is delivered to it. Zero disables the timeout.
+        /// Only the state the machine settles in after a transition arms the timer, timeouts of its parents are not considered.
+        /// Arming goes through [`xTimerPendFunctionCall`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/11-Software-timers/18-xTimerPendFunctionCall), which requires `INCLUDE_xTimerPendFunctionCall`.
+        time::Milliseconds timeout = time::Milliseconds::zero();
+        Event timeout_event = {};
+    };
+
+    /// Moves the machine from `from` to `to` when `event` is received, running `action` in between exiting and entering states.
+    struct Transition {
+        State from;
+        Event event;
+        State to;
+        Action action = nullptr;
+    };
+
+    /// The compile-time representation of a machine's states and transitions.
+    /// Declare tables as `static constexpr` objects so they live in flash instead of RAM.
+    class Table {
+    public:
+        /// Builds the table, flattening the hierarchy so that every state directly holds the transitions it inherits from its parents.
+        /// States without a configuration have no parent, actions or timeout.
+        consteval Table(std::initializer_list<StateConfig> states, std::initializer_list<Transition> transitions);
+
+    private:
+        friend Machine;
+
+        struct Cell {
+            State target;
+            Action action;
+            bool valid;
+        };
+
+        const StateConfig& config(State state) const { return m_states[index(state)]; }
+        const Cell& cell(State state, Event event) const { return m_cells[index(state)][index(event)]; }
+
+        std::array<StateConfig, STATE_COUNT> m_states;
+        std::array<size_t, STATE_COUNT> m_depth;
+        std::array<std::array<Cell, EVENT_COUNT>, STATE_COUNT> m_cells;
+    };
+
+    /// Constructs a new machine that will start at the `initial` state.
+    /// The machine is not yet valid and must be made so by calling the `create()` function before being used.
+    Machine(const Table&, State initial, Ctx&, Inbox&);
+
+    // Envelopes and the timer refer to the machine by address, so it must stay in place.
+    Machine(Machine&&) = delete;
+    Machine& operator=(Machine&&) = delete;
+    Machine(const Machine&) = delete;
+    Machine& operator=(const Machine&) = delete;
+
+    /// Creates the machine's timer and enters the initial state, running the entry actions of it and it's parents.
+    /// Must be called from the task that hosts the machine.
+    void create(const char* name = nullptr);
+
+    /// Immediately processes the event, returning whether it was handled by the current state or one of it's parents.
+    /// Must be called from the task that hosts the machine, use `post()` from anywhere else.
+    bool dispatch(Event);
+
+    /// Waits up to `timeout` amount of time for the event to be sent to the machine's inbox and returns whether it successfully did so.
+    /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
+    template<typename Rep, typename Period>
+    [[nodiscard]] bool post(Event, std::chrono::duration<Rep, Period> timeout);
+
+    /// Waits indefinitely for the event to be sent to the machine's inbox.
+    void await_post(Event);
+
+    /// Obtains the current (innermost) state.
+    [[nodiscard]] State state() const;
+
+    /// Returns whether the current state is the given state or is nested in it.
+    [[nodiscard]] bool is_in(State) const;
+
+    /// Obtains the number of timeouts that were lost because the inbox was full when they fired.
+    [[nodiscard]] uint32_t missed_timeouts() const;
+
+private:
+    static constexpr size_t index(State state) { return static_cast<size_t>(state); }
+    static constexpr size_t index(Event event) { return static_cast<size_t>(event); }
+
+    static void handler(void* machine, uint32_t event, uint32_t epoch);
+    static void on_timer(Machine*&);
+    static void arm(void* machine, uint32_t epoch);
+
+    void transition(State target, Action action);
+    void enter(State);
+    void exit(State);
+    // Arms or disarms the timer according to the state the machine settled in.
+    void settle(bool was_timed);
+    std::optional<State> parent(State state) const { return m_table.config(state).parent; }
+
+    const Table& m_table;
+    State m_state;
+    Ctx& m_ctx;
+    Inbox& m_inbox;
+
+    std::atomic<uint32_t> m_epoch { 0 };
+    // The epoch carried by the timer when it fires, only ever written by the timer daemon task.
+    std::atomic<uint32_t> m_armed_epoch { 0 };
+    std::atomic<uint32_t> m_missed_timeouts { 0 };
+    timer::Timer<Machine*> m_timer;
+};
+
+template<Enumeration State, Enumeration Event, typename Ctx>
+consteval Machine<State, Event, Ctx>::Table::Table(std::initializer_list<StateConfig> states, std::initializer_list<Transition> transitions)
+    : m_states {}
+    , m_depth {}
+    , m_cells {} {
+    for (size_t i = 0; i < STATE_COUNT; ++i)
+        m_states[i].state = static_cast<State>(i);
+
+    for (const auto& state : states)
+        m_states[index(state.state)] = state;
+
+    for (size_t i = 0; i < STATE_COUNT; ++i) {
+        size_t depth = 0;
+        for (auto parent = m_states[i].parent; parent; parent = m_states[index(*parent)].parent) {
+            if (++depth >= STATE_COUNT)
+                detail::invalid_table("The state hierarchy contains a cycle");
+        }
+        m_depth[i] = depth;
+    }
+
+    for (const auto& transition : transitions) {
+        auto& cell = m_cells[index(transition.from)][index(transition.event)];
+        if (cell.valid)
+            detail::invalid_table("A state has two transitions for the same event");
+        cell = { transition.to, transition.action, true };
+    }
+
+    // Inherit the transitions of the parents, shallower states first so that inheritance is transitive.
+    for (size_t depth = 1; depth < STATE_COUNT; ++depth) {
+        for (size_t i = 0; i < STATE_COUNT; ++i) {
+            if (m_depth[i] != depth)
+                continue;
+
+            const auto& parent_cells = m_cells[index(*m_states[i].parent)];
+            for (size_t event = 0; event < EVENT_COUNT; ++event) {
+                if (not m_cells[i][event].valid)
+                    m_cells[i][event] = parent_cells[event];
+            }
+        }
+    }
+}
+
+template<Enumeration State, Enumeration Event, typename Ctx>
+Machine<State, Event, Ctx>::Machine(const Table& table, State initial, Ctx& ctx, Inbox& inbox)
+    : m_table(table)
+    , m_state(initial)
+    , m_ctx(ctx)
+    , m_inbox(inbox)
+    , m_timer(timer::Mode::SingleShot, &Machine::on_timer, this) {
+}
+
+template<Enumeration State, Enumeration Event, typename Ctx>
+void Machine<State, Event, Ctx>::create(const char* name) {
+    // The period is replaced whenever a state with a timeout is entered.
+    m_timer.create(name, time::Duration { 1 });
+
+    std::array<State, STATE_COUNT> path;
+    size_t length = 0;
+    for (std::optional<State> state = m_state; state; state = parent(*state))
+        path[length++] = *state;
+
+    while (length > 0)
+        enter(path[--length]);
+
+    settle(false);
+}
+
+template<Enumeration State, Enumeration Event, typename Ctx>
+bool Machine<State, Event, Ctx>::dispatch(Event event) {
+    const auto& cell = m_table.cell(m_state, event);
+    if (not cell.valid)
+        return false;
+
+    transition(cell.target, cell.action);
+    return true;
+}
+
+template<Enumeration State, Enumeration Event, typename Ctx>
+template<typename Rep, typename Period>
+bool Machine<State, Event, Ctx>::post(Event event, std::chrono::duration<Rep, Period> timeout) {
+    return m_inbox.send(Envelope { this, &Machine::handler, static_cast<uint32_t>(event), 0 }, timeout);
+}
+
+template<Enumeration State, Enumeration Event, typename Ctx>
+void Machine<State, Event, Ctx>::await_post(Event event) {
+    (void)post(event, time::FOREVER);
+}
+
+template<Enumeration State, Enumeration Event, typename Ctx>
+State Machine<State, Event, Ctx>::state() const {
+    return m_state;
+}
+
+template<Enumeration State, Enumeration Event, typename Ctx>
+bool Machine<State, Event, Ctx>::is_in(State state) const {
+    for (std::optional<State> current = m_state; current; current = parent(*current)) {
+        if (*current == state)
+            return true;
+    }
+    return false;
+}
+
+template<Enumeration State, Enumeration Event, typename Ctx>
+uint32_t Machine<State, Event, Ctx>::missed_timeouts() const {
+    return m_missed_timeouts.load(std::memory_order_relaxed);
+}
+
+template<Enumeration State, Enumeration Event, typename Ctx>
+void Machine<State, Event, Ctx>::handler(void* machine, uint32_t event, uint32_t epoch) {
+    auto& self = *static_cast<Machine*>(machine);
+
+    // A timeout that fired right before it's state was exited.
+    if (epoch != 0 and epoch != self.m_epoch.load(std::memory_order_relaxed))
+        return;
+
+    (void)self.dispatch(epoch != 0 ? self.m_table.config(self.m_state).timeout_event : static_cast<Event>(event));
+}
+
+template<Enumeration State, Enumeration Event, typename Ctx>
+void Machine<State, Event, Ctx>::on_timer(Machine*& self) {
+    const Envelope envelope {
+        self,
+        &Machine::handler,
+        0,
+        self->m_armed_epoch.load(std::memory_order_relaxed),
+    };
+
+    // Never block the timer daemon task.
+    if (not self->m_inbox.send(envelope, time::NO_WAIT))
+        self->m_missed_timeouts.fetch_add(1, std::memory_order_relaxed);
+}
+
+template<Enumeration State, Enumeration Event, typename Ctx>
+void Machine<State, Event, Ctx>::arm(void* machine, uint32_t epoch) {
+    static_cast<Machine*>(machine)->m_armed_epoch.store(epoch, std::memory_order_relaxed);
+}
+
+template<Enumeration State, Enumeration Event, typename Ctx>
+void Machine<State, Event, Ctx>::transition(State target, Action action) {
+    const bool was_timed = m_table.config(m_state).timeout > time::Milliseconds::zero();
+
+    // Find the least common ancestor of the current and target states.
+    std::optional<State> source_ancestor = m_state;
+    std::optional<State> target_ancestor = target;
+    while (m_table.m_depth[index(*source_ancestor)] > m_table.m_depth[index(*target_ancestor)])
+        source_ancestor = parent(*source_ancestor);
+    while (m_table.m_depth[index(*target_ancestor)] > m_table.m_depth[index(*source_ancestor)])
+        target_ancestor = parent(*target_ancestor);
+    while (source_ancestor != target_ancestor) {
+        source_ancestor = parent(*source_ancestor);
+        target_ancestor = parent(*target_ancestor);
+    }
+
+    // Transitions to the current state or one of it's parents exit and re-enter the target.
+    auto ancestor = source_ancestor;
+    if (ancestor == target)
+        ancestor = parent(target);
+
+    for (std::optional<State> state = m_state; state != ancestor; state = parent(*state))
+        exit(*state);
+
+    if (action)
+        action(m_ctx);
+
+    std::array<State, STATE_COUNT> path;
+    size_t length = 0;
+    for (std::optional<State> state = target; state != ancestor; state = parent(*state))
+        path[length++] = *state;
+
+    while (length > 0)
+        enter(path[--length]);
+
+    settle(was_timed);
+}
+
+template<Enumeration State, Enumeration Event, typename Ctx>
+void Machine<State, Event, Ctx>::enter(State state) {
+    m_state = state;
+
+    const auto& config = m_table.config(state);
+    if (config.on_entry)
+        config.on_entry(m_ctx);
+}
+
+template<Enumeration State, Enumeration Event, typename Ctx>
+void Machine<State, Event, Ctx>::exit(State state) {
+    const auto& config = m_table.config(state);
+    if (config.on_exit)
+        config.on_exit(m_ctx);
+}
+
+template<Enumeration State, Enumeration Event, typename Ctx>
+void Machine<State, Event, Ctx>::settle(bool was_timed) {
+    // Zero is reserved for regular events.
+    auto epoch = m_epoch.load(std::memory_order_relaxed) + 1;
+    epoch = epoch == 0 ? 1 : epoch;
+    m_epoch.store(epoch, std::memory_order_relaxed);
+
+    // The timer daemon processes commands in order, so the new epoch is only armed once the previous timer can't fire anymore, and before the new one is started.
+    // A timeout firing in between still carries the previous epoch and is dropped once delivered.
+    if (was_timed)
+        m_timer.await_stop();
+
+    const auto& config = m_table.config(m_state);
+    if (config.timeout > time::Milliseconds::zero()) {
+        (void)xTimerPendFunctionCall(&Machine::arm, this, epoch, portMAX_DELAY);
+        m_timer.await_change_period(config.timeout);
+    }
+}
+
+}
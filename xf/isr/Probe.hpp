@@ -0,0 +1,158 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <utility>
+
+#include <freertos/FreeRTOS.h>
+
+#if ESP_PLATFORM
+#    include <esp_cpu.h>
+#endif
+
+#include <xf/config.hpp>
+
+#if XF_ISR_INSTRUMENTATION
+#    include <xf/time/CycleClock.hpp>
+#    include <xf/time/Histogram.hpp>
+#endif
+
+namespace xf::isr {
+
+/// Execution time and wake-up latency statistics of a single ISR, filled in by `Measured` when `XF_ISR_INSTRUMENTATION` is enabled.
+/// While an ISR is being measured, every task it wakes up through an ISR-safe queue or notification is stamped with the current time, and the woken task can then call `record_latency()` as soon as it runs to record how long it took to get there.
+/// Since `CycleClock` counters are per-core, latencies are only meaningful when the ISR and the woken task run on the same core.
+class Probe {
+public:
+    /// Constructs a new probe with the given name, which is kept only for reporting purposes.
+    explicit constexpr Probe(const char* name)
+        : m_name(name) { }
+
+    Probe(const Probe&) = delete;
+    Probe& operator=(const Probe&) = delete;
+
+    /// Obtains the name of the probe.
+    [[nodiscard]] const char* name() const { return m_name; }
+
+#if XF_ISR_INSTRUMENTATION
+    /// Obtains the histogram of how long the ISR takes from entry to exit.
+    /// Only available when `XF_ISR_INSTRUMENTATION` is enabled.
+    [[nodiscard]] const time::Histogram& execution() const { return m_execution; }
+
+    /// Obtains the histogram of how long it takes from the ISR waking a task up to that task calling `record_latency()`.
+    /// Only available when `XF_ISR_INSTRUMENTATION` is enabled.
+    [[nodiscard]] const time::Histogram& latency() const { return m_latency; }
+#endif
+
+    /// Records the time elapsed since the latest wake-up stamped by the ISR and returns whether there was any.
+    /// Always returns false when `XF_ISR_INSTRUMENTATION` is disabled.
+    /// Should be called by the woken task right after the wait that the ISR ended, e.g: right after `Queue::await_receive()` returns.
+    bool record_latency();
+
+    /// Obtains the probe of the ISR currently being measured on the calling core, if any.
+    [[nodiscard]] static Probe* current();
+
+    /// Stamps a wake-up performed by the ISR being measured on the calling core, if any.
+    /// Called by every ISR-safe queue and notification operation, does nothing when `XF_ISR_INSTRUMENTATION` is disabled.
+    static void stamp_wake();
+
+private:
+    friend class Measured;
+
+#if ESP_PLATFORM
+    static constexpr size_t CORES = portNUM_PROCESSORS;
+#else
+    static constexpr size_t CORES = 1;
+#endif
+
+    static Probe*& current_slot();
+
+    const char* m_name;
+#if XF_ISR_INSTRUMENTATION
+    time::Histogram m_execution;
+    time::Histogram m_latency;
+    std::atomic<time::CycleClock::rep> m_wake_stamp { 0 };
+    std::atomic<bool> m_wake_pending { false };
+#endif
+
+    static inline std::array<Probe*, CORES> s_current {};
+};
+
+/// Measures the ISR it's declared in for as long as it is alive, recording into the given probe.
+/// Should be the first thing declared in the ISR, e.g:
+/// ```cpp
+/// static xf::isr::Probe probe { "uart" };
+/// void IRAM_ATTR on_uart() {
+///     xf::isr::YieldScope scope;
+///     xf::isr::Measured measured { probe };
+///     ...
+/// }
+/// ```
+/// Does nothing when `XF_ISR_INSTRUMENTATION` is disabled.
+class Measured {
+public:
+    explicit Measured(Probe& probe)
+#if XF_ISR_INSTRUMENTATION
+        : m_probe(probe)
+        , m_previous(std::exchange(Probe::current_slot(), &probe))
+        , m_start(time::CycleClock::now())
+#endif
+    {
+        (void)probe;
+    }
+
+    Measured(const Measured&) = delete;
+    Measured& operator=(const Measured&) = delete;
+
+    ~Measured() {
+#if XF_ISR_INSTRUMENTATION
+        m_probe.m_execution.record(time::CycleClock::now() - m_start);
+        // ISRs nest on the same core, so the previous probe is always the one that was interrupted.
+        Probe::current_slot() = m_previous;
+#endif
+    }
+
+#if XF_ISR_INSTRUMENTATION
+private:
+    Probe& m_probe;
+    Probe* m_previous;
+    time::CycleClock::time_point m_start;
+#endif
+};
+
+inline Probe*& Probe::current_slot() {
+#if ESP_PLATFORM
+    return s_current[esp_cpu_get_core_id()];
+#else
+    return s_current[0];
+#endif
+}
+
+inline Probe* Probe::current() {
+    return current_slot();
+}
+
+inline void Probe::stamp_wake() {
+#if XF_ISR_INSTRUMENTATION
+    if (auto* probe = current()) {
+        probe->m_wake_stamp.store(time::CycleClock::now().time_since_epoch().count(), std::memory_order_relaxed);
+        probe->m_wake_pending.store(true, std::memory_order_release);
+    }
+#endif
+}
+
+inline bool Probe::record_latency() {
+#if XF_ISR_INSTRUMENTATION
+    const auto now = time::CycleClock::now();
+    if (not m_wake_pending.exchange(false, std::memory_order_acquire))
+        return false;
+
+    const auto stamp = time::CycleClock::time_point { time::CycleClock::duration { m_wake_stamp.load(std::memory_order_relaxed) } };
+    m_latency.record(now - stamp);
+    return true;
+#else
+    return false;
+#endif
+}
+
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <concepts>
+#include <optional>
 
 #include <freertos/FreeRTOS.h>
 
@@ -10,10 +11,67 @@ namespace xf::isr {
 using HigherPriorityTaskWoken = bool;
 
 /// When no arguments are passed, always performs a context switch.
-/// When one or more arguments are passed, performs a context switch if all of the arguments evaluate to `true`.
+/// When one or more arguments are passed, performs a context switch if any of the arguments evaluate to `true`.
 void yield(std::convertible_to<HigherPriorityTaskWoken> auto&&... yield) {
-    if (true and (HigherPriorityTaskWoken(yield) or ...))
+    if (sizeof...(yield) == 0 or (HigherPriorityTaskWoken(yield) or ...))
         portYIELD_FROM_ISR();
 }
 
+/// Collects the `HigherPriorityTaskWoken` of every operation performed by an ISR and performs a single context switch when the scope ends, if any of them woke a higher priority task.
+/// Every ISR-safe operation in xf can be recorded by passing it's result through `record()`, e.g:
+/// ```cpp
+/// xf::isr::YieldScope scope;
+/// if (scope.record(queue.send(sample)))
+///     scope.record(notification.set());
+/// ```
+class YieldScope {
+public:
+    YieldScope() = default;
+    YieldScope(const YieldScope&) = delete;
+    YieldScope& operator=(const YieldScope&) = delete;
+
+    /// Performs a context switch if any of the recorded operations woke a higher priority task.
+    ~YieldScope() {
+        if (m_yield)
+            portYIELD_FROM_ISR();
+    }
+
+    /// Records an operation that always succeeds.
+    void record(HigherPriorityTaskWoken higher_priority_task_woken) {
+        m_yield = m_yield or higher_priority_task_woken;
+    }
+
+    /// Records an operation that can fail and returns whether it was successful.
+    [[nodiscard]] bool record(std::optional<HigherPriorityTaskWoken> result) {
+        if (result)
+            record(*result);
+        return result.has_value();
+    }
+
+    /// Records an operation that produces data alongside it's `higher_priority_task_woken` (e.g: `Queue::receive()`) and returns the result untouched.
+    template<typename Data>
+        requires requires(const Data& data) { { data.higher_priority_task_woken } -> std::convertible_to<HigherPriorityTaskWoken>; }
+    [[nodiscard]] std::optional<Data> record(std::optional<Data> result) {
+        if (result)
+            record(result->higher_priority_task_woken);
+        return result;
+    }
+
+    /// Records an operation that can't fail and produces data alongside it's `higher_priority_task_woken` (e.g: `StreamChannel::send()`) and returns the result untouched.
+    template<typename Data>
+        requires requires(const Data& data) { { data.higher_priority_task_woken } -> std::convertible_to<HigherPriorityTaskWoken>; }
+    Data record(Data result) {
+        record(result.higher_priority_task_woken);
+        return result;
+    }
+
+    /// Returns whether a context switch will be performed when the scope ends.
+    [[nodiscard]] bool will_yield() const {
+        return m_yield;
+    }
+
+private:
+    bool m_yield = false;
+};
+
 }
@@ -0,0 +1,260 @@
+#include "BufferChain.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace xf::mem {
+
+SegmentPool::SegmentPool(std::span<Segment> segments, std::span<Fragment> fragments, std::span<std::byte> storage, size_t segment_size)
+    : m_segment_size(segment_size) {
+    for (size_t i = 0; i < segments.size(); ++i) {
+        segments[i].data = storage.data() + i * segment_size;
+        segments[i].next_free = std::exchange(m_free_segments, &segments[i]);
+    }
+    for (auto& fragment : fragments)
+        fragment.next = std::exchange(m_free_fragments, &fragment);
+    m_free_segment_count = segments.size();
+}
+
+std::optional<BufferChain> SegmentPool::allocate(size_t size) {
+    const size_t segments = (size + m_segment_size - 1) / m_segment_size;
+
+    Fragment* head = nullptr;
+    Fragment* tail = nullptr;
+    const bool allocated = locked([&] {
+        if (segments > m_free_segment_count)
+            return false;
+
+        size_t left = size;
+        for (size_t i = 0; i < segments; ++i) {
+            auto* fragment = m_free_fragments;
+            if (fragment == nullptr) {
+                // Give back what was taken so far, the chain is all or nothing.
+                while (head) {
+                    auto* next = head->next;
+                    head->segment->next_free = std::exchange(m_free_segments, head->segment);
+                    ++m_free_segment_count;
+                    head->next = std::exchange(m_free_fragments, head);
+                    head = next;
+                }
+                return false;
+            }
+            m_free_fragments = fragment->next;
+
+            auto* segment = std::exchange(m_free_segments, m_free_segments->next_free);
+            --m_free_segment_count;
+            segment->references.store(1, std::memory_order_relaxed);
+
+            const auto length = static_cast<uint16_t>(std::min(left, m_segment_size));
+            left -= length;
+            *fragment = Fragment { segment, 0, length, nullptr };
+            if (tail)
+                tail->next = fragment;
+            else
+                head = fragment;
+            tail = fragment;
+        }
+        return true;
+    });
+
+    if (not allocated)
+        return std::nullopt;
+    return BufferChain { this, head, tail, size };
+}
+
+size_t SegmentPool::free_segments() {
+    return locked([&] { return m_free_segment_count; });
+}
+
+Fragment* SegmentPool::new_fragment(Segment* segment, uint16_t offset, uint16_t length) {
+    auto* fragment = locked([&] {
+        auto* fragment = m_free_fragments;
+        if (fragment)
+            m_free_fragments = fragment->next;
+        return fragment;
+    });
+    if (fragment)
+        *fragment = Fragment { segment, offset, length, nullptr };
+    return fragment;
+}
+
+Segment* SegmentPool::new_segment() {
+    auto* segment = locked([&] {
+        auto* segment = m_free_segments;
+        if (segment) {
+            m_free_segments = segment->next_free;
+            --m_free_segment_count;
+        }
+        return segment;
+    });
+    if (segment)
+        segment->references.store(1, std::memory_order_relaxed);
+    return segment;
+}
+
+void SegmentPool::free_segment(Segment* segment) {
+    locked([&] {
+        segment->next_free = std::exchange(m_free_segments, segment);
+        ++m_free_segment_count;
+    });
+}
+
+void SegmentPool::retain(Segment* segment) {
+    segment->references.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SegmentPool::release(Fragment* chain) {
+    locked([&] {
+        while (chain) {
+            auto* next = chain->next;
+            if (chain->segment->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                chain->segment->next_free = std::exchange(m_free_segments, chain->segment);
+                ++m_free_segment_count;
+            }
+            chain->next = std::exchange(m_free_fragments, chain);
+            chain = next;
+        }
+    });
+}
+
+BufferChain::BufferChain(SegmentPool* pool, Fragment* head, Fragment* tail, size_t size)
+    : m_pool(pool)
+    , m_head(head)
+    , m_tail(tail)
+    , m_size(size) {
+}
+
+std::optional<std::span<std::byte>> BufferChain::prepend(size_t size) {
+    configASSERT(m_pool);
+    if (size > m_pool->segment_size())
+        return std::nullopt;
+
+    // Grow into the room left in front of the first fragment, as long as no other chain can see that segment.
+    if (m_head and m_head->offset >= size and m_head->segment->references.load(std::memory_order_acquire) == 1) {
+        m_head->offset -= size;
+        m_head->length += size;
+        m_size += size;
+        return std::span { m_head->segment->data + m_head->offset, size };
+    }
+
+    auto* segment = m_pool->new_segment();
+    if (segment == nullptr)
+        return std::nullopt;
+
+    // Data is placed at the end of the segment, leaving room for the headers prepended after it.
+    const auto offset = static_cast<uint16_t>(m_pool->segment_size() - size);
+    auto* fragment = m_pool->new_fragment(segment, offset, static_cast<uint16_t>(size));
+    if (fragment == nullptr) {
+        m_pool->free_segment(segment);
+        return std::nullopt;
+    }
+
+    link_front(fragment);
+    return std::span { segment->data + offset, size };
+}
+
+std::optional<std::span<std::byte>> BufferChain::append(size_t size) {
+    configASSERT(m_pool);
+    if (size > m_pool->segment_size())
+        return std::nullopt;
+
+    // Grow into the room left behind the last fragment, as long as no other chain can see that segment.
+    if (m_tail and m_tail->offset + m_tail->length + size <= m_pool->segment_size() and m_tail->segment->references.load(std::memory_order_acquire) == 1) {
+        auto* data = m_tail->segment->data + m_tail->offset + m_tail->length;
+        m_tail->length += size;
+        m_size += size;
+        return std::span { data, size };
+    }
+
+    auto* segment = m_pool->new_segment();
+    if (segment == nullptr)
+        return std::nullopt;
+
+    auto* fragment = m_pool->new_fragment(segment, 0, static_cast<uint16_t>(size));
+    if (fragment == nullptr) {
+        m_pool->free_segment(segment);
+        return std::nullopt;
+    }
+
+    link_back(fragment);
+    return std::span { segment->data, size };
+}
+
+void BufferChain::append(BufferChain& other) {
+    if (other.m_head == nullptr)
+        return;
+
+    configASSERT(m_pool == nullptr or m_pool == other.m_pool);
+    m_pool = other.m_pool;
+    if (m_tail)
+        m_tail->next = other.m_head;
+    else
+        m_head = other.m_head;
+    m_tail = other.m_tail;
+    m_size += other.m_size;
+
+    other = BufferChain {};
+}
+
+std::optional<BufferChain> BufferChain::slice(size_t offset, size_t length) const {
+    if (offset + length > m_size)
+        return std::nullopt;
+
+    BufferChain slice { m_pool, nullptr, nullptr, 0 };
+    for (auto* fragment = m_head; fragment and length > 0; fragment = fragment->next) {
+        if (offset >= fragment->length) {
+            offset -= fragment->length;
+            continue;
+        }
+
+        const auto taken = static_cast<uint16_t>(std::min<size_t>(fragment->length - offset, length));
+        auto* shared = m_pool->new_fragment(fragment->segment, static_cast<uint16_t>(fragment->offset + offset), taken);
+        if (shared == nullptr) {
+            slice.release();
+            return std::nullopt;
+        }
+        m_pool->retain(fragment->segment);
+
+        slice.link_back(shared);
+        length -= taken;
+        offset = 0;
+    }
+    return slice;
+}
+
+std::span<std::byte> BufferChain::copy_to(std::span<std::byte> out) const {
+    size_t copied = 0;
+    for (auto* fragment = m_head; fragment and copied < out.size(); fragment = fragment->next) {
+        const size_t length = std::min<size_t>(fragment->length, out.size() - copied);
+        std::memcpy(out.data() + copied, fragment->segment->data + fragment->offset, length);
+        copied += length;
+    }
+    return out.first(copied);
+}
+
+void BufferChain::release() {
+    if (m_head)
+        m_pool->release(m_head);
+    *this = BufferChain {};
+}
+
+void BufferChain::link_front(Fragment* fragment) {
+    fragment->next = m_head;
+    m_head = fragment;
+    if (m_tail == nullptr)
+        m_tail = fragment;
+    m_size += fragment->length;
+}
+
+void BufferChain::link_back(Fragment* fragment) {
+    fragment->next = nullptr;
+    if (m_tail)
+        m_tail->next = fragment;
+    else
+        m_head = fragment;
+    m_tail = fragment;
+    m_size += fragment->length;
+}
+
+}
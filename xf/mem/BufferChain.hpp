@@ -0,0 +1,157 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include <xf/sync/CriticalSection.hpp>
+
+namespace xf::mem {
+
+class BufferChain;
+
+/// A fixed-size block of memory owned by a `SegmentPool` and shared, through reference counting, by every `BufferChain` that points into it.
+struct Segment {
+    std::byte* data;
+    std::atomic<uint16_t> references { 0 };
+    Segment* next_free { nullptr };
+};
+
+/// A contiguous range of bytes inside a segment, linked to the next range of the same chain.
+struct Fragment {
+    Segment* segment;
+    uint16_t offset;
+    uint16_t length;
+    Fragment* next;
+};
+
+/// A fixed pool of segments and fragments that `BufferChain`s are built from.
+/// Allocating and freeing only takes a short critical section, from either a task or an ISR, and never touches the heap.
+/// See `StaticSegmentPool` for the version of this class that owns it's memory.
+class SegmentPool {
+public:
+    /// Allocates a chain of `size` bytes spread over as many segments as needed, which the caller is free to write to, or `std::nullopt` if the pool ran out of segments or fragments.
+    [[nodiscard]] std::optional<BufferChain> allocate(size_t size);
+
+    /// Obtains the size of every segment in bytes.
+    [[nodiscard]] size_t segment_size() const { return m_segment_size; }
+
+    /// Obtains the amount of segments that aren't referenced by any chain.
+    [[nodiscard]] size_t free_segments();
+
+protected:
+    SegmentPool(std::span<Segment>, std::span<Fragment>, std::span<std::byte> storage, size_t segment_size);
+
+private:
+    friend class BufferChain;
+
+    Fragment* new_fragment(Segment*, uint16_t offset, uint16_t length);
+    Segment* new_segment();
+    void free_segment(Segment*);
+    void retain(Segment*);
+    void release(Fragment* chain);
+
+    // Safe to enter from both tasks and ISRs.
+    template<typename FN>
+    auto locked(FN&& callback) { return m_lock.locked_from_isr(std::forward<FN>(callback)); }
+
+    sync::CriticalSection m_lock;
+    size_t m_segment_size;
+    Segment* m_free_segments { nullptr };
+    Fragment* m_free_fragments { nullptr };
+    size_t m_free_segment_count { 0 };
+};
+
+namespace detail {
+
+// The memory of a `StaticSegmentPool`, inherited from before `SegmentPool` so that it's alive by the time `SegmentPool`'s constructor threads the free lists through it.
+template<size_t SEGMENTS, size_t SEGMENT_SIZE, size_t FRAGMENTS>
+struct SegmentPoolStorage {
+    std::array<Segment, SEGMENTS> m_segments;
+    std::array<Fragment, FRAGMENTS> m_fragments;
+    alignas(std::max_align_t) std::array<std::byte, SEGMENTS * SEGMENT_SIZE> m_storage;
+};
+
+}
+
+/// A `SegmentPool` owning the memory for `SEGMENTS` segments of `SEGMENT_SIZE` bytes and `FRAGMENTS` fragments.
+/// Chains use one fragment per contiguous range, so slicing and prepending need more fragments than there are segments.
+template<size_t SEGMENTS, size_t SEGMENT_SIZE, size_t FRAGMENTS = SEGMENTS * 2>
+class StaticSegmentPool : private detail::SegmentPoolStorage<SEGMENTS, SEGMENT_SIZE, FRAGMENTS>, public SegmentPool {
+public:
+    static_assert(SEGMENT_SIZE > 0 and SEGMENT_SIZE <= UINT16_MAX, "Segment size must fit in a 16-bit length");
+    static_assert(FRAGMENTS >= SEGMENTS, "Every segment needs at least one fragment to be used");
+
+    StaticSegmentPool()
+        : SegmentPool(this->m_segments, this->m_fragments, this->m_storage, SEGMENT_SIZE) { }
+
+    // Chains point into the pool's storage, so it can't be moved nor copied.
+    StaticSegmentPool(const StaticSegmentPool&) = delete;
+    StaticSegmentPool& operator=(const StaticSegmentPool&) = delete;
+};
+
+/// A sequence of bytes scattered over reference-counted segments of a `SegmentPool`, e.g: a network frame.
+/// Prepending a header, appending a trailer, concatenating and slicing chains never copies the payload, only links fragments of segments together, so a frame can travel from a driver ISR through every layer of a protocol stack without a single `memcpy`.
+/// Chains are trivially copyable handles: send them through a `Queue` or an `isr::Queue` as-is, but there must only be one owner at a time, which must call `release()` once it's done with the chain.
+class BufferChain {
+public:
+    /// Constructs an empty chain that doesn't belong to any pool.
+    BufferChain() = default;
+
+    /// Links a new fragment of `size` bytes in front of the chain and returns it for the caller to write to, or `std::nullopt` if the pool ran out of memory or `size` is larger than a segment.
+    [[nodiscard]] std::optional<std::span<std::byte>> prepend(size_t size);
+
+    /// Links a new fragment of `size` bytes to the back of the chain and returns it for the caller to write to, or `std::nullopt` if the pool ran out of memory or `size` is larger than a segment.
+    [[nodiscard]] std::optional<std::span<std::byte>> append(size_t size);
+
+    /// Moves every fragment of `other`, which must come from the same pool, to the back of the chain, leaving `other` empty.
+    void append(BufferChain& other);
+
+    /// Creates a new chain sharing the bytes in the range `[offset, offset + length)` of this chain, or `std::nullopt` if the range is out of bounds or the pool ran out of fragments.
+    /// Both chains must be released independently.
+    [[nodiscard]] std::optional<BufferChain> slice(size_t offset, size_t length) const;
+
+    /// Invokes the callback with every contiguous range of bytes in the chain, in order, e.g: to fill a scatter-gather DMA descriptor list.
+    template<typename FN>
+    void for_each_fragment(FN&& callback) const;
+
+    /// Copies up to `out.size()` bytes from the front of the chain and returns the part of `out` that was filled.
+    std::span<std::byte> copy_to(std::span<std::byte> out) const;
+
+    /// Obtains the amount of bytes in the chain.
+    [[nodiscard]] size_t size() const { return m_size; }
+
+    /// Returns whether the chain holds no bytes.
+    [[nodiscard]] bool is_empty() const { return m_size == 0; }
+
+    /// Drops the chain's references to it's segments, freeing the ones no other chain refers to, and leaves the chain empty.
+    void release();
+
+private:
+    friend class SegmentPool;
+
+    BufferChain(SegmentPool*, Fragment* head, Fragment* tail, size_t size);
+
+    void link_front(Fragment*);
+    void link_back(Fragment*);
+
+    SegmentPool* m_pool { nullptr };
+    Fragment* m_head { nullptr };
+    Fragment* m_tail { nullptr };
+    size_t m_size { 0 };
+};
+
+static_assert(std::is_trivially_copyable_v<BufferChain>, "Chains must be trivially copyable to be sent through queues as-is");
+
+template<typename FN>
+void BufferChain::for_each_fragment(FN&& callback) const {
+    for (auto* fragment = m_head; fragment; fragment = fragment->next)
+        callback(std::span<const std::byte> { fragment->segment->data + fragment->offset, fragment->length });
+}
+
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <type_traits>
+
+#include <xf/sync/CriticalSection.hpp>
+#include <xf/sync/LightSemaphore.hpp>
+#include <xf/time/time.hpp>
+
+namespace xf::queue {
+
+/// A statically allocated queue of key-value updates that only ever holds the latest value of each key, up to `LENGTH` distinct keys.
+/// Sending an update for a key that is already queued replaces it's value in place, keeping it's original position, so a lagging consumer only ever sees fresh values and the length of the queue is bound by the number of distinct keys instead of by the rate of updates.
+/// Keys are looked up in constant time through a small open-addressing hash index, using `std::hash`.
+/// Keys and values are copied inside a critical section, so they must be trivially copyable and should be small.
+/// Not ISR-safe.
+template<typename Key, typename Value, size_t LENGTH>
+class CoalescingQueue {
+public:
+    static_assert(std::is_trivially_copyable_v<Key> and std::is_trivially_copyable_v<Value>, "Keys and values must be trivially copyable since they are copied inside a critical section");
+    static_assert(std::equality_comparable<Key>, "Keys must be comparable for equality");
+    static_assert(LENGTH > 0 and LENGTH < UINT16_MAX, "Length must be at least 1 and fit in a 16-bit index");
+
+    struct Entry {
+        Key key;
+        Value value;
+    };
+
+    /// Queues the update, replacing the value of the key if it is already queued, and returns whether it was successful, which it isn't when `LENGTH` other keys are already queued.
+    [[nodiscard]] bool send(const Key&, const Value&);
+
+    /// Waits indefinitely for an update to be popped from the front of the queue.
+    [[nodiscard]] Entry await_receive();
+
+    /// Waits up to `timeout` amount of time for an update to be popped from the front of the queue.
+    /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
+    template<typename Rep, typename Period>
+    [[nodiscard]] std::optional<Entry> receive(std::chrono::duration<Rep, Period> timeout);
+
+    /// Obtains the number of distinct keys in the queue.
+    [[nodiscard]] size_t messages_waiting() const;
+
+    /// Obtains the number of updates that replaced the value of a key that was already queued.
+    [[nodiscard]] uint32_t coalesced() const;
+
+private:
+    // The index is kept at most half full so that probe sequences stay short.
+    static constexpr size_t INDEX_SIZE = std::bit_ceil(LENGTH * 2);
+    static constexpr uint16_t EMPTY = UINT16_MAX;
+
+    static size_t home(const Key&);
+    size_t find(const Key&) const;
+    void erase(size_t position);
+    Entry pop();
+
+    sync::CriticalSection m_lock;
+    sync::LightSemaphore m_available;
+
+    std::array<Entry, LENGTH> m_entries {};
+    // Positions of the entries in arrival order, as a ring.
+    std::array<uint16_t, LENGTH> m_order {};
+    size_t m_head { 0 };
+    size_t m_size { 0 };
+    // Maps hashed keys to entries. The entries that aren't in use are the ones not referenced by `m_order`.
+    std::array<uint16_t, INDEX_SIZE> m_index = [] {
+        std::array<uint16_t, INDEX_SIZE> index;
+        index.fill(EMPTY);
+        return index;
+    }();
+    std::array<uint16_t, LENGTH> m_free = [] {
+        std::array<uint16_t, LENGTH> free;
+        for (size_t i = 0; i < LENGTH; ++i)
+            free[i] = static_cast<uint16_t>(i);
+        return free;
+    }();
+    std::atomic<uint32_t> m_coalesced { 0 };
+};
+
+template<typename Key, typename Value, size_t LENGTH>
+bool CoalescingQueue<Key, Value, LENGTH>::send(const Key& key, const Value& value) {
+    enum class Outcome {
+        Coalesced,
+        Queued,
+        Full,
+    };
+
+    const auto outcome = m_lock.locked([&] {
+        const size_t position = find(key);
+        if (m_index[position] != EMPTY) {
+            m_entries[m_index[position]].value = value;
+            m_coalesced.fetch_add(1, std::memory_order_relaxed);
+            return Outcome::Coalesced;
+        }
+
+        if (m_size == LENGTH)
+            return Outcome::Full;
+
+        // Entries are handed out from the back of the free list, which holds `LENGTH - m_size` of them.
+        const uint16_t entry = m_free[LENGTH - m_size - 1];
+        m_entries[entry] = Entry { key, value };
+        m_index[position] = entry;
+        m_order[(m_head + m_size) % LENGTH] = entry;
+        ++m_size;
+        return Outcome::Queued;
+    });
+
+    if (outcome == Outcome::Queued)
+        m_available.give();
+    return outcome != Outcome::Full;
+}
+
+template<typename Key, typename Value, size_t LENGTH>
+typename CoalescingQueue<Key, Value, LENGTH>::Entry CoalescingQueue<Key, Value, LENGTH>::await_receive() {
+    m_available.await_take();
+    return pop();
+}
+
+template<typename Key, typename Value, size_t LENGTH>
+template<typename Rep, typename Period>
+std::optional<typename CoalescingQueue<Key, Value, LENGTH>::Entry> CoalescingQueue<Key, Value, LENGTH>::receive(std::chrono::duration<Rep, Period> timeout) {
+    if (not m_available.take(timeout))
+        return std::nullopt;
+    return pop();
+}
+
+template<typename Key, typename Value, size_t LENGTH>
+size_t CoalescingQueue<Key, Value, LENGTH>::messages_waiting() const {
+    return m_available.count();
+}
+
+template<typename Key, typename Value, size_t LENGTH>
+uint32_t CoalescingQueue<Key, Value, LENGTH>::coalesced() const {
+    return m_coalesced.load(std::memory_order_relaxed);
+}
+
+template<typename Key, typename Value, size_t LENGTH>
+size_t CoalescingQueue<Key, Value, LENGTH>::home(const Key& key) {
+    return std::hash<Key> {}(key) & (INDEX_SIZE - 1);
+}
+
+// Returns the position in the index holding the key, or the empty position where it would be inserted.
+template<typename Key, typename Value, size_t LENGTH>
+size_t CoalescingQueue<Key, Value, LENGTH>::find(const Key& key) const {
+    size_t position = home(key);
+    while (m_index[position] != EMPTY and not(m_entries[m_index[position]].key == key))
+        position = (position + 1) & (INDEX_SIZE - 1);
+    return position;
+}
+
+// Removes a position from the index, shifting back the entries that probed past it so that lookups never stop early.
+template<typename Key, typename Value, size_t LENGTH>
+void CoalescingQueue<Key, Value, LENGTH>::erase(size_t position) {
+    size_t hole = position;
+    size_t next = (hole + 1) & (INDEX_SIZE - 1);
+    while (m_index[next] != EMPTY) {
+        const size_t wanted = home(m_entries[m_index[next]].key);
+        // Only move the entry if the hole lies between where it wants to be and where it is, cyclically.
+        if (((next - wanted) & (INDEX_SIZE - 1)) >= ((next - hole) & (INDEX_SIZE - 1))) {
+            m_index[hole] = m_index[next];
+            hole = next;
+        }
+        next = (next + 1) & (INDEX_SIZE - 1);
+    }
+    m_index[hole] = EMPTY;
+}
+
+// Must only be called after taking a permit from `m_available`, which guarantees there is an entry to pop.
+template<typename Key, typename Value, size_t LENGTH>
+typename CoalescingQueue<Key, Value, LENGTH>::Entry CoalescingQueue<Key, Value, LENGTH>::pop() {
+    return m_lock.locked([&] {
+        const uint16_t entry = m_order[m_head];
+        m_head = (m_head + 1) % LENGTH;
+        --m_size;
+        m_free[LENGTH - m_size - 1] = entry;
+
+        erase(find(m_entries[entry].key));
+        return m_entries[entry];
+    });
+}
+
+}
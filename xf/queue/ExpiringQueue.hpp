@@ -0,0 +1,141 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+#include "Queue.hpp"
+#include "StaticQueue.hpp"
+#include <xf/time/time.hpp>
+
+namespace xf::queue {
+
+/// An item stored in an `ExpiringQueue`, alongside the tick it was sent at and how long it stays valid for.
+template<typename Item>
+struct Stamped {
+    Item item;
+    time::Tick sent;
+    time::Duration ttl;
+};
+
+/// A queue whose items are only valid for a limited amount of time after being sent, e.g: setpoints that become dangerous once stale.
+/// Every item is stamped with the tick it was sent at and a time-to-live. Items that outlived it by the time they are received are discarded (and destroyed, if heap-backed) in bulk and counted, so a receiver never sees a stale item.
+/// Receiving also reports how long each item waited in the queue, for latency monitoring.
+/// Backed by a `Queue` by default, see `StaticExpiringQueue` for a statically-allocated version of this class.
+template<typename Item, typename Backing = Queue<Stamped<Item>>>
+class ExpiringQueue {
+public:
+    struct Delivery {
+        Item item;
+        /// How long the item waited in the queue, from being sent to being received.
+        time::Duration delay;
+    };
+
+    /// Creates the underlying queue, forwarding the arguments to it's `create()` function.
+    template<typename... Args>
+    decltype(auto) create(Args&&... args) { return m_queue.create(std::forward<Args>(args)...); }
+
+    /// Waits indefinitely for the item to be pushed to the back of the queue, valid for `ttl` amount of time from now.
+    template<typename Rep, typename Period>
+    void await_send(Item, std::chrono::duration<Rep, Period> ttl);
+
+    /// Waits up to `timeout` amount of time for the item to be pushed to the back of the queue, valid for `ttl` amount of time from now, and returns whether it successfully did so.
+    /// Time spent waiting for room counts towards the time-to-live.
+    /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
+    template<typename Rep, typename Period, typename TimeoutRep, typename TimeoutPeriod>
+    [[nodiscard]] bool send(Item, std::chrono::duration<Rep, Period> ttl, std::chrono::duration<TimeoutRep, TimeoutPeriod> timeout);
+
+    /// Waits indefinitely for an item that hasn't expired to be popped from the front of the queue, discarding every expired item in front of it.
+    [[nodiscard]] Delivery await_receive();
+
+    /// Waits up to `timeout` amount of time for an item that hasn't expired to be popped from the front of the queue, discarding every expired item in front of it.
+    /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
+    template<typename Rep, typename Period>
+    [[nodiscard]] std::optional<Delivery> receive(std::chrono::duration<Rep, Period> timeout);
+
+    /// Obtains the number of items that were discarded because they expired before being received.
+    [[nodiscard]] uint32_t expired() const;
+
+    /// Obtains the number of items stored in the queue, including the ones that have already expired but weren't discarded yet.
+    [[nodiscard]] size_t messages_waiting() const;
+
+    /// Obtains the underlying queue.
+    [[nodiscard]] Backing& backing();
+
+private:
+    Backing m_queue;
+    std::atomic<uint32_t> m_expired { 0 };
+};
+
+/// A statically allocated version of `ExpiringQueue`, holding up to `LENGTH` items.
+template<typename Item, size_t LENGTH>
+using StaticExpiringQueue = ExpiringQueue<Item, StaticQueue<Stamped<Item>, LENGTH>>;
+
+template<typename Item, typename Backing>
+template<typename Rep, typename Period>
+void ExpiringQueue<Item, Backing>::await_send(Item item, std::chrono::duration<Rep, Period> ttl) {
+    (void)send(std::move(item), ttl, time::FOREVER);
+}
+
+template<typename Item, typename Backing>
+template<typename Rep, typename Period, typename TimeoutRep, typename TimeoutPeriod>
+bool ExpiringQueue<Item, Backing>::send(Item item, std::chrono::duration<Rep, Period> ttl, std::chrono::duration<TimeoutRep, TimeoutPeriod> timeout) {
+    return m_queue.send(Stamped<Item> { std::move(item), time::Clock::now(), time::Duration { time::to_raw_tick(ttl) } }, timeout);
+}
+
+template<typename Item, typename Backing>
+typename ExpiringQueue<Item, Backing>::Delivery ExpiringQueue<Item, Backing>::await_receive() {
+    return std::move(*receive(time::FOREVER));
+}
+
+template<typename Item, typename Backing>
+template<typename Rep, typename Period>
+std::optional<typename ExpiringQueue<Item, Backing>::Delivery> ExpiringQueue<Item, Backing>::receive(std::chrono::duration<Rep, Period> timeout) {
+    const TickType_t ticks = time::to_raw_tick(timeout);
+    const auto start = time::Clock::now();
+    uint32_t expired = 0;
+
+    std::optional<Delivery> delivery;
+    while (true) {
+        auto remaining = time::Duration { ticks };
+        // Discarding expired items doesn't extend the timeout, only the time that is left is waited for.
+        if (ticks != portMAX_DELAY) {
+            const auto elapsed = time::Clock::now() - start;
+            remaining = elapsed < remaining ? remaining - elapsed : time::Duration { 0 };
+        }
+
+        auto stamped = m_queue.receive(remaining);
+        if (not stamped)
+            break;
+
+        const auto delay = time::Clock::now() - stamped->sent;
+        if (delay <= stamped->ttl) {
+            delivery.emplace(Delivery { std::move(stamped->item), delay });
+            break;
+        }
+        ++expired;
+    }
+
+    if (expired > 0)
+        m_expired.fetch_add(expired, std::memory_order_relaxed);
+    return delivery;
+}
+
+template<typename Item, typename Backing>
+uint32_t ExpiringQueue<Item, Backing>::expired() const {
+    return m_expired.load(std::memory_order_relaxed);
+}
+
+template<typename Item, typename Backing>
+size_t ExpiringQueue<Item, Backing>::messages_waiting() const {
+    return m_queue.messages_waiting();
+}
+
+template<typename Item, typename Backing>
+Backing& ExpiringQueue<Item, Backing>::backing() {
+    return m_queue;
+}
+
+}
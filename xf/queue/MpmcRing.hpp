@@ -0,0 +1,268 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include <xf/sync/CriticalSection.hpp>
+#include <xf/sync/WaitList.hpp>
+#include <xf/time/time.hpp>
+
+namespace xf::queue {
+
+/// A statically allocated, bounded, multi-producer multi-consumer queue holding up to `LENGTH` items.
+/// Sending and receiving are lock-free when the queue isn't full or empty, respectively: each slot carries a sequence number that producers and consumers claim with a single compare-and-swap (Dmitry Vyukov's algorithm), so producers and consumers on different cores don't contend on the kernel's global lock like they do with `Queue`.
+/// Only tasks that have to wait for room or for items block, on a `WaitList`, and are woken through their notification at `XF_SYNC_NOTIFICATION_INDEX`.
+/// Items are moved in and out of the queue, but must not throw when moved.
+/// Not ISR-safe.
+template<typename Item, size_t LENGTH>
+class MpmcRing {
+public:
+    static_assert(std::has_single_bit(LENGTH) and LENGTH >= 2, "Length must be a power of two, and at least 2");
+    static_assert(std::is_nothrow_move_constructible_v<Item>, "Items must not throw when moved");
+
+    MpmcRing();
+
+    /// Destroys every item left in the queue.
+    ~MpmcRing();
+
+    MpmcRing(const MpmcRing&) = delete;
+    MpmcRing& operator=(const MpmcRing&) = delete;
+
+    /// Tries pushing the item to the back of the queue without waiting and returns whether it was successful.
+    [[nodiscard]] bool try_send(Item);
+
+    /// Waits indefinitely for the item to be pushed to the back of the queue.
+    void await_send(Item);
+
+    /// Waits up to `timeout` amount of time for the item to be pushed to the back of the queue and returns whether it was successful.
+    /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
+    template<typename Rep, typename Period>
+    [[nodiscard]] bool send(Item, std::chrono::duration<Rep, Period> timeout);
+
+    /// Tries popping an item from the front of the queue without waiting.
+    [[nodiscard]] std::optional<Item> try_receive();
+
+    /// Waits indefinitely for an item to be popped from the front of the queue.
+    [[nodiscard]] Item await_receive();
+
+    /// Waits up to `timeout` amount of time for an item to be popped from the front of the queue.
+    /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
+    template<typename Rep, typename Period>
+    [[nodiscard]] std::optional<Item> receive(std::chrono::duration<Rep, Period> timeout);
+
+    /// Obtains an approximation of the number of items stored in the queue, which might already be outdated by the time it returns.
+    [[nodiscard]] size_t messages_waiting() const;
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        alignas(Item) std::byte storage[sizeof(Item)];
+    };
+
+    static constexpr size_t MASK = LENGTH - 1;
+
+    bool push(Item&);
+    std::optional<Item> pop();
+
+    // Waits until `attempt` succeeds, blocking on `waiters` in between tries.
+    template<typename FN>
+    static auto blocking(sync::CriticalSection&, sync::WaitList& waiters, std::atomic<uint32_t>& waiting, TickType_t ticks, FN&& attempt);
+    static void wake_one(sync::CriticalSection&, sync::WaitList& waiters, std::atomic<uint32_t>& waiting);
+
+    std::array<Slot, LENGTH> m_slots;
+    std::atomic<size_t> m_enqueue_position { 0 };
+    std::atomic<size_t> m_dequeue_position { 0 };
+
+    sync::CriticalSection m_lock;
+    sync::WaitList m_senders;
+    sync::WaitList m_receivers;
+    std::atomic<uint32_t> m_senders_waiting { 0 };
+    std::atomic<uint32_t> m_receivers_waiting { 0 };
+};
+
+template<typename Item, size_t LENGTH>
+MpmcRing<Item, LENGTH>::MpmcRing() {
+    for (size_t i = 0; i < LENGTH; ++i)
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+template<typename Item, size_t LENGTH>
+MpmcRing<Item, LENGTH>::~MpmcRing() {
+    while (pop())
+        ;
+}
+
+template<typename Item, size_t LENGTH>
+bool MpmcRing<Item, LENGTH>::try_send(Item item) {
+    if (not push(item))
+        return false;
+
+    wake_one(m_lock, m_receivers, m_receivers_waiting);
+    return true;
+}
+
+template<typename Item, size_t LENGTH>
+void MpmcRing<Item, LENGTH>::await_send(Item item) {
+    (void)send(std::move(item), time::FOREVER);
+}
+
+template<typename Item, size_t LENGTH>
+template<typename Rep, typename Period>
+bool MpmcRing<Item, LENGTH>::send(Item item, std::chrono::duration<Rep, Period> timeout) {
+    if (not blocking(m_lock, m_senders, m_senders_waiting, time::to_raw_tick(timeout), [&] { return push(item); }))
+        return false;
+
+    wake_one(m_lock, m_receivers, m_receivers_waiting);
+    return true;
+}
+
+template<typename Item, size_t LENGTH>
+std::optional<Item> MpmcRing<Item, LENGTH>::try_receive() {
+    auto item = pop();
+    if (item)
+        wake_one(m_lock, m_senders, m_senders_waiting);
+    return item;
+}
+
+template<typename Item, size_t LENGTH>
+Item MpmcRing<Item, LENGTH>::await_receive() {
+    return std::move(*receive(time::FOREVER));
+}
+
+template<typename Item, size_t LENGTH>
+template<typename Rep, typename Period>
+std::optional<Item> MpmcRing<Item, LENGTH>::receive(std::chrono::duration<Rep, Period> timeout) {
+    auto item = blocking(m_lock, m_receivers, m_receivers_waiting, time::to_raw_tick(timeout), [&] { return pop(); });
+    if (item)
+        wake_one(m_lock, m_senders, m_senders_waiting);
+    return item;
+}
+
+template<typename Item, size_t LENGTH>
+size_t MpmcRing<Item, LENGTH>::messages_waiting() const {
+    const size_t enqueued = m_enqueue_position.load(std::memory_order_relaxed);
+    const size_t dequeued = m_dequeue_position.load(std::memory_order_relaxed);
+    return enqueued >= dequeued ? std::min(enqueued - dequeued, LENGTH) : 0;
+}
+
+template<typename Item, size_t LENGTH>
+bool MpmcRing<Item, LENGTH>::push(Item& item) {
+    size_t position = m_enqueue_position.load(std::memory_order_relaxed);
+    while (true) {
+        auto& slot = m_slots[position & MASK];
+        const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        if (difference == 0) {
+            if (m_enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                std::construct_at(reinterpret_cast<Item*>(slot.storage), std::move(item));
+                slot.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (difference < 0) {
+            // The slot still holds an item from the previous lap: the queue is full.
+            return false;
+        } else {
+            position = m_enqueue_position.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template<typename Item, size_t LENGTH>
+std::optional<Item> MpmcRing<Item, LENGTH>::pop() {
+    size_t position = m_dequeue_position.load(std::memory_order_relaxed);
+    while (true) {
+        auto& slot = m_slots[position & MASK];
+        const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+        if (difference == 0) {
+            if (m_dequeue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                auto* stored = std::launder(reinterpret_cast<Item*>(slot.storage));
+                std::optional<Item> item { std::move(*stored) };
+                std::destroy_at(stored);
+                slot.sequence.store(position + LENGTH, std::memory_order_release);
+                return item;
+            }
+        } else if (difference < 0) {
+            // The slot hasn't been written to in this lap yet: the queue is empty.
+            return std::nullopt;
+        } else {
+            position = m_dequeue_position.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+// `waiting` is raised before the last attempt, while the other side checks it right after making room or publishing an item.
+// The fences make sure at least one of the sides sees the other, so a wake-up can't be missed.
+template<typename Item, size_t LENGTH>
+template<typename FN>
+auto MpmcRing<Item, LENGTH>::blocking(sync::CriticalSection& lock, sync::WaitList& waiters, std::atomic<uint32_t>& waiting, TickType_t ticks, FN&& attempt) {
+    const TickType_t start = xTaskGetTickCount();
+    while (true) {
+        if (auto result = attempt())
+            return result;
+
+        TickType_t remaining = ticks;
+        if (ticks != portMAX_DELAY) {
+            const TickType_t elapsed = xTaskGetTickCount() - start;
+            if (elapsed >= ticks)
+                return decltype(attempt()) {};
+            remaining = ticks - elapsed;
+        }
+
+        sync::Waiter waiter;
+        lock.locked([&] {
+            waiting.fetch_add(1, std::memory_order_relaxed);
+            waiters.push(waiter);
+        });
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (auto result = attempt()) {
+            const bool queued = lock.locked([&] {
+                if (waiter.woken)
+                    return false;
+                (void)waiters.remove(waiter);
+                waiting.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            });
+            // Woken in the meantime: the wake-up has to be consumed, and passed on since it went unused.
+            if (not queued) {
+                (void)ulTaskNotifyTakeIndexed(XF_SYNC_NOTIFICATION_INDEX, pdTRUE, portMAX_DELAY);
+                wake_one(lock, waiters, waiting);
+            }
+            return result;
+        }
+
+        if (not waiters.wait(lock, waiter, remaining)) {
+            waiting.fetch_sub(1, std::memory_order_relaxed);
+            return decltype(attempt()) {};
+        }
+    }
+}
+
+template<typename Item, size_t LENGTH>
+void MpmcRing<Item, LENGTH>::wake_one(sync::CriticalSection& lock, sync::WaitList& waiters, std::atomic<uint32_t>& waiting) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting.load(std::memory_order_relaxed) == 0)
+        return;
+
+    sync::WaitList::wake(lock.locked([&] {
+        auto* waiter = waiters.pop();
+        if (waiter)
+            waiting.fetch_sub(1, std::memory_order_relaxed);
+        return waiter;
+    }));
+}
+
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "StaticQueue.hpp"
+#include "isr/PingPong.hpp"
+#include <xf/time/time.hpp>
+
+namespace xf::queue {
+
+/// A set of `BUFFERS` statically allocated buffers of type `T` passed back and forth between a producer and a consumer without ever being copied, e.g: blocks of ADC samples.
+/// The producer writes directly into the "back" buffer and publishes it once it's complete, which hands it to the consumer and moves the producer on to the next free buffer.
+/// The consumer waits for published buffers and processes them in place, after which they become free again.
+/// When the consumer falls behind and no buffer is free, publishing keeps the producer on the same buffer, dropping it's contents, and counts an overrun instead of overwriting a buffer that is still being processed.
+/// There must only be one producer and one consumer. The producer can either be a task or an ISR, through `for_isr()`.
+/// The object is not yet valid and must be made so by calling the `create()` function before being used.
+template<typename T, size_t BUFFERS = 2>
+class PingPong {
+public:
+    static_assert(BUFFERS >= 2, "At least two buffers are needed for the producer and the consumer to work at the same time");
+    static_assert(BUFFERS <= UINT8_MAX, "Buffers are indexed by an 8-bit integer");
+
+    PingPong() = default;
+
+    // The queues hold indices into this object's storage, so it can't be moved nor copied.
+    PingPong(const PingPong&) = delete;
+    PingPong& operator=(const PingPong&) = delete;
+
+    /// Creates the underlying queues and hands the first buffer to the producer.
+    void create();
+
+    /// Obtains the buffer the producer is currently filling. Must only be called by the producer.
+    [[nodiscard]] T& back();
+
+    /// Hands the back buffer to the consumer and moves on to the next free one, returning whether there was one.
+    /// When there isn't, the back buffer is kept, it's contents are dropped and an overrun is counted. Must only be called by the producer, from a task.
+    bool publish();
+
+    /// Waits indefinitely for a buffer to be published, then invokes the callback with it and frees it.
+    template<std::invocable<T&> FN>
+    void await_consume(FN&& callback);
+
+    /// Waits up to `timeout` amount of time for a buffer to be published, then invokes the callback with it, frees it and returns `true`. Returns `false` if no buffer was published in time.
+    /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
+    template<std::invocable<T&> FN, typename Rep, typename Period>
+    bool consume(FN&& callback, std::chrono::duration<Rep, Period> timeout);
+
+    /// Obtains the amount of buffers that were dropped because the consumer didn't free any in time.
+    [[nodiscard]] uint32_t overruns() const;
+
+    /// Obtains the amount of published buffers waiting for the consumer.
+    [[nodiscard]] size_t buffers_ready() const;
+
+    /// Creates an ISR-safe version of the producer side.
+    [[nodiscard]] isr::PingPong<T, BUFFERS> for_isr();
+
+private:
+    friend class isr::PingPong<T, BUFFERS>;
+
+    std::array<T, BUFFERS> m_buffers {};
+    StaticQueue<uint8_t, BUFFERS> m_free;
+    StaticQueue<uint8_t, BUFFERS> m_ready;
+    uint8_t m_back { 0 };
+    std::atomic<uint32_t> m_overruns { 0 };
+};
+
+template<typename T, size_t BUFFERS>
+void PingPong<T, BUFFERS>::create() {
+    m_free.create();
+    m_ready.create();
+
+    m_back = 0;
+    for (uint8_t i = 1; i < BUFFERS; ++i)
+        (void)m_free.send(i, time::Duration { 0 });
+}
+
+template<typename T, size_t BUFFERS>
+T& PingPong<T, BUFFERS>::back() {
+    return m_buffers[m_back];
+}
+
+template<typename T, size_t BUFFERS>
+bool PingPong<T, BUFFERS>::publish() {
+    const auto next = m_free.receive(time::Duration { 0 });
+    if (not next) {
+        m_overruns.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // There is always room: every index is in exactly one place at a time.
+    (void)m_ready.send(m_back, time::Duration { 0 });
+    m_back = *next;
+    return true;
+}
+
+template<typename T, size_t BUFFERS>
+template<std::invocable<T&> FN>
+void PingPong<T, BUFFERS>::await_consume(FN&& callback) {
+    (void)consume(std::forward<FN>(callback), time::FOREVER);
+}
+
+template<typename T, size_t BUFFERS>
+template<std::invocable<T&> FN, typename Rep, typename Period>
+bool PingPong<T, BUFFERS>::consume(FN&& callback, std::chrono::duration<Rep, Period> timeout) {
+    const auto index = m_ready.receive(timeout);
+    if (not index)
+        return false;
+
+    std::invoke(std::forward<FN>(callback), m_buffers[*index]);
+    (void)m_free.send(*index, time::Duration { 0 });
+    return true;
+}
+
+template<typename T, size_t BUFFERS>
+uint32_t PingPong<T, BUFFERS>::overruns() const {
+    return m_overruns.load(std::memory_order_relaxed);
+}
+
+template<typename T, size_t BUFFERS>
+size_t PingPong<T, BUFFERS>::buffers_ready() const {
+    return m_ready.messages_waiting();
+}
+
+template<typename T, size_t BUFFERS>
+isr::PingPong<T, BUFFERS> PingPong<T, BUFFERS>::for_isr() {
+    return isr::PingPong<T, BUFFERS> { *this };
+}
+
+}
@@ -1,51 +1,40 @@
 #pragma once
 
+#include <concepts>
+#include <memory>
+#include <new>
 #include <optional>
+#include <span>
 #include <utility>
 
 #include <freertos/FreeRTOS.h>
 #include <freertos/queue.h>
 
+#include "QueueCore.hpp"
 #include "isr/Queue.hpp"
-#include <xf/mem/mem.hpp>
 #include <xf/time/time.hpp>
 
 namespace xf::queue {
 
-using Handle = QueueHandle_t;
-
 /// A high level abstraction over a dynamically allocated FreeRTOS Queue that provides type and object safety.
 /// Non-trivially copyable items are heap allocated when sent, stored in the underlying queue using a pointer and then free'd when receiving, which allows conveniently passing complex types like `std::vector` or `std::string` in a memory-safe manner. Even though move semantics are respected when possible this can be considered a performance footgun, so statically asserting that your message type is trivially copyable is recommended to avoid potential performance regressions.
+/// The work is done by the untyped `QueueCore`, which this class is a thin typed shell around, so the many `Queue` instantiations of a program share a single copy of the code. Operations that don't depend on the type of the item, like `messages_waiting()`, are documented there.
 /// See `StaticQueue` for a statically-allocated version of this class.
 /// See https://freertos.org/Documentation/02-Kernel/02-Kernel-features/02-Queues-mutexes-and-semaphores/01-Queues for more information on how FreeRTOS queues work.
 template<typename Item>
-class Queue {
+class Queue : public QueueCore {
 public:
     /// Constructs a new queue.
     /// The queue is not yet valid and must be made so by calling the `create()` function before being used.
     Queue() = default;
 
-    /// Destroys the queue if it has been created, does nothing otherwise.
-    ~Queue();
-
-    Queue(Queue&&) noexcept;
-    Queue& operator=(Queue&&) noexcept;
-
-    // There is no mechanism in FreeRTOS to copy a queue
-    Queue(const Queue&) = delete;
-    Queue operator=(const Queue&) = delete;
-
     /// Creates the queue with the given length, which is the maximum number of items the queue can hold.
     /// Analogous to [`xQueueCreate`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/06-Queues/01-xQueueCreate).
     [[nodiscard]] bool create(size_t length);
 
-    /// Delete a queue - freeing all the memory allocated for storing of items placed on the queue.
-    /// Analogous to [`vQueueDelete`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/06-Queues/00-QueueManagement#vqueuedelete).
-    void destroy();
-
     /// Waits indefinitely for the item to be pushed to the back of the queue.
     /// Analogous to [`xQueueSend`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/06-Queues/03-xQueueSend).
-    void await_send(const Item&);
+    void await_send(const Item&) requires std::copy_constructible<Item>;
 
     /// Waits indefinitely for the item to be pushed to the back of the queue.
     /// Analogous to [`xQueueSend`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/06-Queues/03-xQueueSend).
@@ -55,7 +44,7 @@ public:
     /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
     /// Analogous to [`xQueueSend`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/06-Queues/03-xQueueSend).
     template<typename Rep, typename Period>
-    [[nodiscard]] bool send(const Item&, std::chrono::duration<Rep, Period> timeout);
+    [[nodiscard]] bool send(const Item&, std::chrono::duration<Rep, Period> timeout) requires std::copy_constructible<Item>;
 
     /// Waits up to `timeout` amount of time for the item to be pushed to the back of the queue and returns whether it successfully did so.
     /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
@@ -65,7 +54,7 @@ public:
 
     /// Waits indefinitely for the item to be pushed to the back of the queue.
     /// Analogous to [`xQueueSendToBack`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/06-Queues/05-xQueueSendToBack).
-    void await_send_to_back(const Item&);
+    void await_send_to_back(const Item&) requires std::copy_constructible<Item>;
 
     /// Waits indefinitely for the item to be pushed to the back of the queue.
     /// Analogous to [`xQueueSendToBack`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/06-Queues/05-xQueueSendToBack).
@@ -75,7 +64,7 @@ public:
     /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
     /// Analogous to [`xQueueSendToBack`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/06-Queues/05-xQueueSendToBack).
     template<typename Rep, typename Period>
-    [[nodiscard]] bool send_to_back(const Item&, std::chrono::duration<Rep, Period> timeout);
+    [[nodiscard]] bool send_to_back(const Item&, std::chrono::duration<Rep, Period> timeout) requires std::copy_constructible<Item>;
 
     /// Waits up to `timeout` amount of time for the item to be pushed to the back of the queue and returns whether it successfully did so.
     /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
@@ -85,7 +74,7 @@ public:
 
     /// Waits indefinitely for the item to be pushed to the front of the queue.
     /// Analogous to [`xQueueSendToFront`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/06-Queues/07-xQueueSendToFront).
-    void await_send_to_front(const Item&);
+    void await_send_to_front(const Item&) requires std::copy_constructible<Item>;
 
     /// Waits indefinitely for the item to be pushed to the front of the queue.
     /// Analogous to [`xQueueSendToFront`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/06-Queues/07-xQueueSendToFront).
@@ -95,7 +84,7 @@ public:
     /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
     /// Analogous to [`xQueueSendToFront`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/06-Queues/07-xQueueSendToFront).
     template<typename Rep, typename Period>
-    [[nodiscard]] bool send_to_front(const Item&, std::chrono::duration<Rep, Period> timeout);
+    [[nodiscard]] bool send_to_front(const Item&, std::chrono::duration<Rep, Period> timeout) requires std::copy_constructible<Item>;
 
     /// Waits up to `timeout` amount of time for the item to be pushed to the front of the queue and returns whether it successfully did so.
     /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
@@ -113,10 +102,22 @@ public:
     template<typename Rep, typename Period>
     [[nodiscard]] std::optional<Item> receive(std::chrono::duration<Rep, Period> timeout) const;
 
+    /// Waits indefinitely for a first item, then keeps popping items into `out` until either it is full, `min_items` have been received or `linger` amount of time has passed since the first item arrived, and returns the part of `out` that was filled.
+    /// Once `min_items` have been received only the items already in the queue are taken, without waiting any further. A `linger` of `time::FOREVER` waits for `min_items` indefinitely.
+    /// Useful for consumers that want to process items in batches without delaying any of them for more than `linger`. Items that arrive together are received in a single wake-up.
+    /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
+    template<typename Rep, typename Period>
+    [[nodiscard]] std::span<Item> await_receive_batch(std::span<Item> out, size_t min_items, std::chrono::duration<Rep, Period> linger) const;
+
+    /// A version of `await_receive_batch()` that waits up to `timeout` amount of time for the first item, returning an empty span if none arrives.
+    /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
+    template<typename Rep, typename Period, typename TimeoutRep, typename TimeoutPeriod>
+    [[nodiscard]] std::span<Item> receive_batch(std::span<Item> out, size_t min_items, std::chrono::duration<Rep, Period> linger, std::chrono::duration<TimeoutRep, TimeoutPeriod> timeout) const;
+
     /// A version of `send_to_back()` that will write to the queue even if the queue is full, overwriting data that is already held in the queue.
     /// This function is intended for use with queues that have a length of one, meaning the queue is either empty or full.
     /// Analogous to [`xQueueOverwrite`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/06-Queues/11-xQueueOverwrite).
-    [[nodiscard]] bool overwrite(const Item&);
+    [[nodiscard]] bool overwrite(const Item&) requires std::copy_constructible<Item>;
 
     /// A version of `send_to_back()` that will write to the queue even if the queue is full, overwriting data that is already held in the queue.
     /// This function is intended for use with queues that have a length of one, meaning the queue is either empty or full.
@@ -125,87 +126,51 @@ public:
 
     /// Waits indefinitely for an item to be received from the front of the queue without popping it.
     /// Analogous to [`xQueuePeek`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/06-Queues/13-xQueuePeek).
-    [[nodiscard]] Item await_peek() const;
+    [[nodiscard]] Item await_peek() const requires std::copy_constructible<Item>;
 
     /// Waits up to `timeout` amount of time for the item to be received from the front of the queue without popping it. Returns the item on success and `std::nullopt` otherwise.
     /// Analogous to [`xQueuePeek`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/06-Queues/13-xQueuePeek).
     template<typename Rep, typename Period>
-    [[nodiscard]] std::optional<Item> peek(std::chrono::duration<Rep, Period> timeout) const;
-
-    /// Obtains the number of messages stored in the queue.
-    /// Analogous to [`uxQueueMessagesWaiting`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/06-Queues/00-QueueManagement#uxqueuemessageswaiting).
-    [[nodiscard]] size_t messages_waiting() const;
-
-    /// Obtains the number of free spaces in the queue.
-    /// Analogous to [`uxQueueSpacesAvailable`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/06-Queues/00-QueueManagement#uxqueuespacesavailable).
-    [[nodiscard]] size_t spaces_available() const;
-
-    /// Resets a queue to its original empty state.
-    /// Analogous to [`xQueueReset`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/06-Queues/00-QueueManagement#xqueuereset).
-    void reset();
-
-    /// Convenience function that reports whether the queue is empty or not. Equivalent to `messages_waiting() == 0`.
-    [[nodiscard]] bool is_empty() const;
-
-    /// Convenience function that reports whether the queue is full or not. Equivalent to `spaces_available() == 0`.
-    [[nodiscard]] bool is_full() const;
-
-    /// Obtains the raw handle backing this queue.
-    [[nodiscard]] Handle raw_handle() const;
+    [[nodiscard]] std::optional<Item> peek(std::chrono::duration<Rep, Period> timeout) const requires std::copy_constructible<Item>;
 
     /// Creates an ISR-safe version of the queue.
     [[nodiscard]] isr::Queue<Item> for_isr();
 
 protected:
-    Handle m_handle { nullptr };
-
     // Non-trivially copyable items are supported through an indirection backed by a heap allocation.
-    using StoredItem = std::conditional_t<
+    using UnstampedItem = std::conditional_t<
         std::is_trivially_copyable_v<Item>,
         Item,
         std::add_pointer_t<Item>>;
 
+#if XF_QUEUE_DWELL_TIME
+    using StoredItem = detail::Enqueued<UnstampedItem>;
+#else
+    using StoredItem = UnstampedItem;
+#endif
+
 private:
-    template<typename T, typename Rep, typename Period>
-    bool generic_send(T&& item, BaseType_t copy_position, std::chrono::duration<Rep, Period> timeout);
-};
+    static constexpr const ItemOps* OPS = item_ops<Item>();
 
-template<typename Item>
-Queue<Item>::~Queue() {
-    if (m_handle)
-        destroy();
-}
+    // What `QueueCore` writes when receiving: trivially copyable items are stored (and thus received) as-is, while the rest are unboxed into the item itself.
+    using ReceivedItem = std::conditional_t<std::is_trivially_copyable_v<Item>, StoredItem, Item>;
 
-template<typename Item>
-Queue<Item>::Queue(Queue&& other) noexcept
-    : m_handle(std::exchange(other.m_handle, nullptr)) {
-}
-
-template<typename Item>
-Queue<Item>& Queue<Item>::operator=(Queue&& other) noexcept {
-    if (this != &other) {
-        if (m_handle)
-            destroy();
-        m_handle = std::exchange(other.m_handle, nullptr);
-    }
-    return *this;
-}
+    template<typename Rep, typename Period>
+    bool generic_send(const Item&, BaseType_t copy_position, std::chrono::duration<Rep, Period> timeout) requires std::copy_constructible<Item>;
+    template<typename Rep, typename Period>
+    bool generic_send(Item&&, BaseType_t copy_position, std::chrono::duration<Rep, Period> timeout);
 
-template<typename Item>
-[[nodiscard]] bool Queue<Item>::create(size_t length) {
-    configASSERT(m_handle == nullptr);
-    m_handle = xQueueCreate(length, sizeof(StoredItem));
-    return m_handle != nullptr;
-}
+    // Moves the item out of the storage filled by `QueueCore` and destroys what is left of it, recording how long it waited in the queue if it was `received` (as opposed to peeked).
+    Item take(std::byte* storage, bool received) const;
+};
 
 template<typename Item>
-void Queue<Item>::destroy() {
-    configASSERT(m_handle);
-    vQueueDelete(std::exchange(m_handle, nullptr));
+bool Queue<Item>::create(size_t length) {
+    return QueueCore::create(length, sizeof(StoredItem));
 }
 
 template<typename Item>
-void Queue<Item>::await_send(const Item& item) {
+void Queue<Item>::await_send(const Item& item) requires std::copy_constructible<Item> {
     (void)send(item, time::FOREVER);
 }
 
@@ -216,7 +181,7 @@ void Queue<Item>::await_send(Item&& item) {
 
 template<typename Item>
 template<typename Rep, typename Period>
-bool Queue<Item>::send(const Item& item, std::chrono::duration<Rep, Period> timeout) {
+bool Queue<Item>::send(const Item& item, std::chrono::duration<Rep, Period> timeout) requires std::copy_constructible<Item> {
     return send_to_back(item, timeout);
 }
 
@@ -227,7 +192,7 @@ bool Queue<Item>::send(Item&& item, std::chrono::duration<Rep, Period> timeout)
 }
 
 template<typename Item>
-void Queue<Item>::await_send_to_back(const Item& item) {
+void Queue<Item>::await_send_to_back(const Item& item) requires std::copy_constructible<Item> {
     (void)send_to_back(item, time::FOREVER);
 }
 
@@ -238,7 +203,7 @@ void Queue<Item>::await_send_to_back(Item&& item) {
 
 template<typename Item>
 template<typename Rep, typename Period>
-bool Queue<Item>::send_to_back(const Item& item, std::chrono::duration<Rep, Period> timeout) {
+bool Queue<Item>::send_to_back(const Item& item, std::chrono::duration<Rep, Period> timeout) requires std::copy_constructible<Item> {
     return generic_send(item, queueSEND_TO_BACK, timeout);
 }
 
@@ -249,7 +214,7 @@ bool Queue<Item>::send_to_back(Item&& item, std::chrono::duration<Rep, Period> t
 }
 
 template<typename Item>
-void Queue<Item>::await_send_to_front(const Item& item) {
+void Queue<Item>::await_send_to_front(const Item& item) requires std::copy_constructible<Item> {
     (void)send_to_front(item, time::FOREVER);
 }
 
@@ -260,7 +225,7 @@ void Queue<Item>::await_send_to_front(Item&& item) {
 
 template<typename Item>
 template<typename Rep, typename Period>
-bool Queue<Item>::send_to_front(const Item& item, std::chrono::duration<Rep, Period> timeout) {
+bool Queue<Item>::send_to_front(const Item& item, std::chrono::duration<Rep, Period> timeout) requires std::copy_constructible<Item> {
     return generic_send(item, queueSEND_TO_FRONT, timeout);
 }
 
@@ -278,102 +243,132 @@ Item Queue<Item>::await_receive() const {
 template<typename Item>
 template<typename Rep, typename Period>
 std::optional<Item> Queue<Item>::receive(std::chrono::duration<Rep, Period> timeout) const {
-    alignas(StoredItem) std::byte buffer[sizeof(StoredItem)];
-    if (xQueueReceive(m_handle, &buffer, time::to_raw_tick(timeout)) == pdFALSE)
+    alignas(ReceivedItem) std::byte storage[sizeof(ReceivedItem)];
+    if (not QueueCore::receive(OPS, storage, time::to_raw_tick(timeout)))
         return std::nullopt;
 
-    if constexpr (std::is_trivially_copyable_v<Item>) {
-        return std::bit_cast<StoredItem>(buffer);
-    } else {
-        auto* stored_item = std::bit_cast<StoredItem>(buffer);
-        auto result { std::move(*stored_item) };
-        mem::destroy(stored_item);
-        return result;
-    }
+    return take(storage, true);
 }
 
 template<typename Item>
-bool Queue<Item>::overwrite(const Item& item) {
-    return generic_send(item, queueOVERWRITE, time::FOREVER);
+template<typename Rep, typename Period>
+std::span<Item> Queue<Item>::await_receive_batch(std::span<Item> out, size_t min_items, std::chrono::duration<Rep, Period> linger) const {
+    return receive_batch(out, min_items, linger, time::FOREVER);
 }
 
 template<typename Item>
-bool Queue<Item>::overwrite(Item&& item) {
-    return generic_send(std::move(item), queueOVERWRITE, time::FOREVER);
-}
+template<typename Rep, typename Period, typename TimeoutRep, typename TimeoutPeriod>
+std::span<Item> Queue<Item>::receive_batch(std::span<Item> out, size_t min_items, std::chrono::duration<Rep, Period> linger, std::chrono::duration<TimeoutRep, TimeoutPeriod> timeout) const {
+    if (out.empty())
+        return out;
 
-template<typename Item>
-Item Queue<Item>::await_peek() const {
-    return peek(time::FOREVER).value();
-}
+    auto first = receive(timeout);
+    if (not first)
+        return out.first(0);
 
-template<typename Item>
-template<typename Rep, typename Period>
-std::optional<Item> Queue<Item>::peek(std::chrono::duration<Rep, Period> timeout) const {
-    alignas(StoredItem) std::byte buffer[sizeof(StoredItem)];
-    if (xQueuePeek(m_handle, &buffer, time::to_raw_tick(timeout)) == pdFALSE)
-        return std::nullopt;
+    const TickType_t linger_ticks = time::to_raw_tick(linger);
+    const TickType_t start = xTaskGetTickCount();
+    out[0] = std::move(*first);
+    size_t received = 1;
 
-    if constexpr (std::is_trivially_copyable_v<Item>) {
-        return std::bit_cast<StoredItem>(buffer);
-    } else {
-        return *std::bit_cast<StoredItem>(buffer);
+    while (received < out.size()) {
+        // Take whatever is already in the queue before deciding whether to block again.
+        if (auto item = receive(time::Duration { 0 })) {
+            out[received++] = std::move(*item);
+            continue;
+        }
+
+        if (received >= min_items)
+            break;
+
+        // Unsigned tick arithmetic keeps the elapsed time right across tick count overflows.
+        TickType_t remaining = portMAX_DELAY;
+        if (linger_ticks != portMAX_DELAY) {
+            const TickType_t elapsed = xTaskGetTickCount() - start;
+            if (elapsed >= linger_ticks)
+                break;
+            remaining = linger_ticks - elapsed;
+        }
+
+        auto item = receive(time::Duration { remaining });
+        if (not item)
+            break;
+        out[received++] = std::move(*item);
     }
+
+    return out.first(received);
 }
 
 template<typename Item>
-void Queue<Item>::reset() {
-    xQueueReset(m_handle);
+bool Queue<Item>::overwrite(const Item& item) requires std::copy_constructible<Item> {
+    return generic_send(item, queueOVERWRITE, time::FOREVER);
 }
 
 template<typename Item>
-size_t Queue<Item>::messages_waiting() const {
-    return uxQueueMessagesWaiting(m_handle);
+bool Queue<Item>::overwrite(Item&& item) {
+    return generic_send(std::move(item), queueOVERWRITE, time::FOREVER);
 }
 
 template<typename Item>
-size_t Queue<Item>::spaces_available() const {
-    return uxQueueSpacesAvailable(m_handle);
+Item Queue<Item>::await_peek() const requires std::copy_constructible<Item> {
+    return peek(time::FOREVER).value();
 }
 
 template<typename Item>
-bool Queue<Item>::is_empty() const {
-    return messages_waiting() == 0;
+template<typename Rep, typename Period>
+std::optional<Item> Queue<Item>::peek(std::chrono::duration<Rep, Period> timeout) const requires std::copy_constructible<Item> {
+    alignas(ReceivedItem) std::byte storage[sizeof(ReceivedItem)];
+    if (not QueueCore::peek(OPS, storage, time::to_raw_tick(timeout)))
+        return std::nullopt;
+
+    return take(storage, false);
 }
 
 template<typename Item>
-bool Queue<Item>::is_full() const {
-    return spaces_available() == 0;
+isr::Queue<Item> Queue<Item>::for_isr() {
+#if XF_QUEUE_DWELL_TIME
+    return isr::Queue<Item> { m_handle, *this };
+#else
+    return isr::Queue<Item> { m_handle };
+#endif
 }
 
 template<typename Item>
-Handle Queue<Item>::raw_handle() const {
-    return m_handle;
+template<typename Rep, typename Period>
+bool Queue<Item>::generic_send(const Item& item, BaseType_t copy_position, std::chrono::duration<Rep, Period> timeout) requires std::copy_constructible<Item> {
+#if XF_QUEUE_DWELL_TIME
+    if constexpr (std::is_trivially_copyable_v<Item>) {
+        const StoredItem stored { time::CycleClock::now().time_since_epoch().count(), item };
+        return QueueCore::send(OPS, &stored, false, copy_position, time::to_raw_tick(timeout));
+    }
+#endif
+    return QueueCore::send(OPS, &item, false, copy_position, time::to_raw_tick(timeout));
 }
 
 template<typename Item>
-isr::Queue<Item> Queue<Item>::for_isr() {
-    return isr::Queue<Item> { m_handle };
+template<typename Rep, typename Period>
+bool Queue<Item>::generic_send(Item&& item, BaseType_t copy_position, std::chrono::duration<Rep, Period> timeout) {
+    // Trivially copyable items have nothing to move
+    if constexpr (std::is_trivially_copyable_v<Item>)
+        return generic_send(static_cast<const Item&>(item), copy_position, timeout);
+    else
+        return QueueCore::send(OPS, &item, true, copy_position, time::to_raw_tick(timeout));
 }
 
 template<typename Item>
-template<typename T, typename Rep, typename Period>
-bool Queue<Item>::generic_send(T&& item, BaseType_t copy_position, std::chrono::duration<Rep, Period> timeout) {
+Item Queue<Item>::take(std::byte* storage, [[maybe_unused]] bool received) const {
+#if XF_QUEUE_DWELL_TIME
     if constexpr (std::is_trivially_copyable_v<Item>) {
-        return xQueueGenericSend(m_handle, &item, time::to_raw_tick(timeout), copy_position) == pdTRUE;
-    } else {
-        auto* new_item = mem::create<Item>(std::forward<T>(item));
-        if (new_item == nullptr)
-            return false;
-
-        if (xQueueGenericSend(m_handle, &new_item, time::to_raw_tick(timeout), copy_position) == pdTRUE) {
-            return true;
-        } else {
-            // Cleanup the allocation before returning failure
-            mem::destroy(new_item);
-            return false;
-        }
+        const auto* stored = std::launder(reinterpret_cast<const StoredItem*>(storage));
+        if (received)
+            record_dwell(stored->sent);
+        return stored->item;
     }
+#endif
+    auto* item = std::launder(reinterpret_cast<Item*>(storage));
+    Item result { std::move(*item) };
+    std::destroy_at(item);
+    return result;
 }
 
 }
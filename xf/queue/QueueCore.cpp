@@ -0,0 +1,163 @@
+#include "QueueCore.hpp"
+
+#include <xf/sync/WaitGraph.hpp>
+
+namespace xf::queue {
+
+namespace {
+
+// Every blocking queue operation goes through these, so the wait-for graph knows what a blocked task is waiting on and who is expected to unblock it.
+
+bool generic_send(Handle handle, const void* item, TickType_t ticks, BaseType_t copy_position) {
+    sync::wait_graph::Blocked blocked { sync::wait_graph::Kind::QueueSend, handle };
+    if (xQueueGenericSend(handle, item, ticks, copy_position) != pdTRUE)
+        return false;
+
+    sync::wait_graph::note_producer(handle);
+    return true;
+}
+
+bool generic_receive(Handle handle, void* destination, TickType_t ticks) {
+    sync::wait_graph::Blocked blocked { sync::wait_graph::Kind::QueueReceive, handle };
+    if (xQueueReceive(handle, destination, ticks) != pdTRUE)
+        return false;
+
+    sync::wait_graph::note_consumer(handle);
+    return true;
+}
+
+bool generic_peek(Handle handle, void* destination, TickType_t ticks) {
+    sync::wait_graph::Blocked blocked { sync::wait_graph::Kind::QueueReceive, handle };
+    return xQueuePeek(handle, destination, ticks) == pdTRUE;
+}
+
+}
+
+QueueCore::~QueueCore() {
+    if (m_handle)
+        destroy();
+}
+
+QueueCore::QueueCore(QueueCore&& other) noexcept
+    : m_handle(std::exchange(other.m_handle, nullptr)) {
+}
+
+QueueCore& QueueCore::operator=(QueueCore&& other) noexcept {
+    if (this != &other) {
+        if (m_handle)
+            destroy();
+        m_handle = std::exchange(other.m_handle, nullptr);
+    }
+    return *this;
+}
+
+bool QueueCore::create(size_t length, size_t stored_item_size) {
+    configASSERT(m_handle == nullptr);
+    m_handle = xQueueCreate(length, stored_item_size);
+    return m_handle != nullptr;
+}
+
+void QueueCore::destroy() {
+    configASSERT(m_handle);
+    vQueueDelete(std::exchange(m_handle, nullptr));
+}
+
+bool QueueCore::send(const ItemOps* ops, const void* item, bool move, BaseType_t copy_position, TickType_t ticks) {
+    if (ops == nullptr)
+        return generic_send(m_handle, item, ticks, copy_position);
+
+    void* box = move ? ops->box_move(const_cast<void*>(item)) : ops->box_copy(item);
+    if (box == nullptr)
+        return false;
+
+#if XF_QUEUE_DWELL_TIME
+    const detail::Enqueued<void*> stored { time::CycleClock::now().time_since_epoch().count(), box };
+#else
+    void* const stored = box;
+#endif
+    if (generic_send(m_handle, &stored, ticks, copy_position))
+        return true;
+
+    // Cleanup the allocation before returning failure
+    ops->destroy(box);
+    return false;
+}
+
+bool QueueCore::receive(const ItemOps* ops, void* destination, TickType_t ticks) const {
+    if (ops == nullptr)
+        return generic_receive(m_handle, destination, ticks);
+
+#if XF_QUEUE_DWELL_TIME
+    detail::Enqueued<void*> stored;
+    if (not generic_receive(m_handle, &stored, ticks))
+        return false;
+
+    record_dwell(stored.sent);
+    void* box = stored.item;
+#else
+    void* box = nullptr;
+    if (not generic_receive(m_handle, &box, ticks))
+        return false;
+#endif
+
+    ops->unbox(box, destination);
+    return true;
+}
+
+bool QueueCore::peek(const ItemOps* ops, void* destination, TickType_t ticks) const {
+    if (ops == nullptr)
+        return generic_peek(m_handle, destination, ticks);
+
+#if XF_QUEUE_DWELL_TIME
+    detail::Enqueued<void*> stored;
+    if (not generic_peek(m_handle, &stored, ticks))
+        return false;
+
+    void* box = stored.item;
+#else
+    void* box = nullptr;
+    if (not generic_peek(m_handle, &box, ticks))
+        return false;
+#endif
+
+    ops->peek(box, destination);
+    return true;
+}
+
+void QueueCore::reset() {
+    xQueueReset(m_handle);
+}
+
+size_t QueueCore::messages_waiting() const {
+    return uxQueueMessagesWaiting(m_handle);
+}
+
+size_t QueueCore::spaces_available() const {
+    return uxQueueSpacesAvailable(m_handle);
+}
+
+bool QueueCore::is_empty() const {
+    return messages_waiting() == 0;
+}
+
+bool QueueCore::is_full() const {
+    return spaces_available() == 0;
+}
+
+Handle QueueCore::raw_handle() const {
+    return m_handle;
+}
+
+#if XF_QUEUE_DWELL_TIME
+
+const time::Histogram& QueueCore::dwell_time() const {
+    return m_dwell_time;
+}
+
+void QueueCore::record_dwell(time::CycleClock::rep sent) const {
+    m_dwell_time.record(time::CycleClock::now() - time::CycleClock::time_point { time::CycleClock::duration { sent } });
+}
+
+#endif
+
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+
+#include <xf/config.hpp>
+#include <xf/mem/mem.hpp>
+#include <xf/time/CycleClock.hpp>
+#include <xf/time/Histogram.hpp>
+
+namespace xf::queue {
+
+namespace isr {
+template<typename Item>
+class Queue;
+}
+
+using Handle = QueueHandle_t;
+
+/// The operations `QueueCore` needs to move a non-trivially copyable item through a queue, which stores a pointer to a heap allocated copy of the item (a "box") instead of the item itself.
+/// Obtained for a given type through `item_ops<Item>()`.
+struct ItemOps {
+    /// Allocates a box holding a copy of the item, returning `nullptr` on allocation failure. `nullptr` for move-only items.
+    void* (*box_copy)(const void* item);
+    /// Allocates a box holding the item, moved out of `item`, returning `nullptr` on allocation failure.
+    void* (*box_move)(void* item);
+    /// Moves the boxed item into the uninitialized storage at `destination` and frees the box.
+    void (*unbox)(void* box, void* destination);
+    /// Copies the boxed item into the uninitialized storage at `destination`, keeping the box. `nullptr` for move-only items.
+    void (*peek)(const void* box, void* destination);
+    /// Destroys the boxed item and frees the box.
+    void (*destroy)(void* box);
+};
+
+namespace detail {
+
+/// How an item is stored in a queue when `XF_QUEUE_DWELL_TIME` is enabled: alongside the `CycleClock` time at which it was sent.
+template<typename T>
+struct Enqueued {
+    time::CycleClock::rep sent;
+    T item;
+};
+
+}
+
+/// Returns the operations used to move `Item` through a queue, or `nullptr` if `Item` is trivially copyable and is stored in the queue as-is.
+template<typename Item>
+consteval const ItemOps* item_ops();
+
+/// The untyped implementation of `Queue`, operating on opaque items.
+/// Every operation that doesn't depend on the type of the item lives here, in a single out-of-line copy shared by every `Queue` instantiation, with `Queue<Item>` being a thin typed shell around it.
+/// Items are passed around as pointers alongside the `ItemOps` of their type (`nullptr` for trivially copyable items, which are copied directly by FreeRTOS).
+/// When `XF_QUEUE_DWELL_TIME` is enabled items are stored as `detail::Enqueued`, which for trivially copyable items is done by `Queue` itself.
+class QueueCore {
+public:
+    QueueCore() = default;
+
+    /// Destroys the queue if it has been created, does nothing otherwise.
+    ~QueueCore();
+
+    QueueCore(QueueCore&&) noexcept;
+    QueueCore& operator=(QueueCore&&) noexcept;
+
+    // There is no mechanism in FreeRTOS to copy a queue
+    QueueCore(const QueueCore&) = delete;
+    QueueCore& operator=(const QueueCore&) = delete;
+
+    /// Delete a queue - freeing all the memory allocated for storing of items placed on the queue.
+    /// Analogous to [`vQueueDelete`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/06-Queues/00-QueueManagement#vqueuedelete).
+    void destroy();
+
+    /// Obtains the number of messages stored in the queue.
+    /// Analogous to [`uxQueueMessagesWaiting`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/06-Queues/00-QueueManagement#uxqueuemessageswaiting).
+    [[nodiscard]] size_t messages_waiting() const;
+
+    /// Obtains the number of free spaces in the queue.
+    /// Analogous to [`uxQueueSpacesAvailable`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/06-Queues/00-QueueManagement#uxqueuespacesavailable).
+    [[nodiscard]] size_t spaces_available() const;
+
+    /// Resets a queue to its original empty state.
+    /// Analogous to [`xQueueReset`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/06-Queues/00-QueueManagement#xqueuereset).
+    void reset();
+
+    /// Convenience function that reports whether the queue is empty or not. Equivalent to `messages_waiting() == 0`.
+    [[nodiscard]] bool is_empty() const;
+
+    /// Convenience function that reports whether the queue is full or not. Equivalent to `spaces_available() == 0`.
+    [[nodiscard]] bool is_full() const;
+
+    /// Obtains the raw handle backing this queue.
+    [[nodiscard]] Handle raw_handle() const;
+
+#if XF_QUEUE_DWELL_TIME
+    /// Obtains the histogram of how long received items waited in the queue, from being sent to being received.
+    /// Since the times are measured with `CycleClock`, items that waited for longer than it's wrap-around period are recorded with a wrapped-around duration.
+    [[nodiscard]] const time::Histogram& dwell_time() const;
+#endif
+
+protected:
+    /// Creates the queue with the given length and size of each stored item.
+    /// Analogous to [`xQueueCreate`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/06-Queues/01-xQueueCreate).
+    [[nodiscard]] bool create(size_t length, size_t stored_item_size);
+
+    /// Pushes the item at `item` to the queue, moving out of it if `move` is set, and returns whether it was successful.
+    /// Analogous to [`xQueueGenericSend`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/06-Queues/00-QueueManagement#xqueuegenericsend).
+    [[nodiscard]] bool send(const ItemOps*, const void* item, bool move, BaseType_t copy_position, TickType_t);
+
+    /// Pops an item into the uninitialized storage at `destination` and returns whether it was successful.
+    /// Analogous to [`xQueueReceive`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/06-Queues/09-xQueueReceive).
+    [[nodiscard]] bool receive(const ItemOps*, void* destination, TickType_t) const;
+
+    /// Copies the front item into the uninitialized storage at `destination` without popping it and returns whether it was successful.
+    /// Analogous to [`xQueuePeek`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/06-Queues/13-xQueuePeek).
+    [[nodiscard]] bool peek(const ItemOps*, void* destination, TickType_t) const;
+
+#if XF_QUEUE_DWELL_TIME
+    template<typename Item>
+    friend class isr::Queue;
+
+    /// Records how long the item sent at `sent` waited in the queue.
+    void record_dwell(time::CycleClock::rep sent) const;
+#endif
+
+    Handle m_handle { nullptr };
+
+#if XF_QUEUE_DWELL_TIME
+private:
+    mutable time::Histogram m_dwell_time;
+#endif
+};
+
+namespace detail {
+
+template<typename Item>
+inline constexpr ItemOps boxed_item_ops {
+    .box_copy = [] {
+        if constexpr (std::is_copy_constructible_v<Item>)
+            return +[](const void* item) -> void* { return mem::create<Item>(*static_cast<const Item*>(item)); };
+        else
+            return static_cast<void* (*)(const void*)>(nullptr);
+    }(),
+    .box_move = [](void* item) -> void* { return mem::create<Item>(std::move(*static_cast<Item*>(item))); },
+    .unbox = [](void* box, void* destination) {
+        auto* item = static_cast<Item*>(box);
+        std::construct_at(static_cast<Item*>(destination), std::move(*item));
+        mem::destroy(item);
+    },
+    .peek = [] {
+        if constexpr (std::is_copy_constructible_v<Item>)
+            return +[](const void* box, void* destination) { std::construct_at(static_cast<Item*>(destination), *static_cast<const Item*>(box)); };
+        else
+            return static_cast<void (*)(const void*, void*)>(nullptr);
+    }(),
+    .destroy = [](void* box) { mem::destroy(static_cast<Item*>(box)); },
+};
+
+}
+
+template<typename Item>
+consteval const ItemOps* item_ops() {
+    if constexpr (std::is_trivially_copyable_v<Item>)
+        return nullptr;
+    else
+        return &detail::boxed_item_ops<Item>;
+}
+
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/stream_buffer.h>
+
+#include "isr/StreamChannel.hpp"
+#include <xf/time/time.hpp>
+
+namespace xf::queue {
+
+/// A statically allocated channel of bytes backed by a FreeRTOS stream buffer, holding up to `CAPACITY` bytes.
+/// Unlike a `Queue<uint8_t>`, any amount of bytes is moved in a single call and a reader blocked on an empty channel is only woken up once at least "trigger level" bytes are available, which makes it a good fit for UART, audio and other byte streams filled from ISRs or DMA callbacks.
+/// Stream buffers assume there is only one writer and one reader at a time, guard them externally otherwise.
+/// The channel is not yet valid and must be made so by calling the `create()` function before being used.
+/// See https://www.freertos.org/Documentation/02-Kernel/02-Kernel-features/04-Stream-and-message-buffers/02-Stream-buffer-example for more information on how FreeRTOS stream buffers work.
+template<size_t CAPACITY>
+class StreamChannel {
+public:
+    static_assert(CAPACITY > 0, "Stream channel capacity must be at least 1");
+
+    StreamChannel() = default;
+
+    /// Destroys the channel if it has been created, does nothing otherwise.
+    ~StreamChannel();
+
+    // The stream buffer points into the storage of this object, so it can't be moved nor copied.
+    StreamChannel(const StreamChannel&) = delete;
+    StreamChannel& operator=(const StreamChannel&) = delete;
+
+    /// Creates the channel, which wakes up a blocked reader once `trigger_level` bytes are available.
+    /// Analogous to [`xStreamBufferCreateStatic`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/07-Stream-buffers/03-xStreamBufferCreateStatic).
+    void create(size_t trigger_level = 1);
+
+    /// Deletes the channel.
+    /// Analogous to [`vStreamBufferDelete`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/07-Stream-buffers/09-vStreamBufferDelete).
+    void destroy();
+
+    /// Waits indefinitely for every byte to be written to the channel.
+    /// Analogous to [`xStreamBufferSend`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/07-Stream-buffers/04-xStreamBufferSend).
+    void await_send(std::span<const uint8_t> bytes);
+
+    /// Waits up to `timeout` amount of time for the bytes to be written to the channel and returns how many were, which might be less than requested.
+    /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
+    /// Analogous to [`xStreamBufferSend`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/07-Stream-buffers/04-xStreamBufferSend).
+    template<typename Rep, typename Period>
+    [[nodiscard]] size_t send(std::span<const uint8_t> bytes, std::chrono::duration<Rep, Period> timeout);
+
+    /// Reads as many bytes as are available and fit in the buffer, returning the part of it that was filled.
+    /// Only blocks while the channel is empty, in which case it waits indefinitely for the trigger level to be reached, any bytes already available are returned immediately, even if fewer than the trigger level.
+    /// Analogous to [`xStreamBufferReceive`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/07-Stream-buffers/06-xStreamBufferReceive).
+    std::span<uint8_t> await_receive(std::span<uint8_t> buffer);
+
+    /// Reads as many bytes as are available and fit in the buffer, returning the part of it that was filled.
+    /// Only blocks while the channel is empty, in which case it waits up to `timeout` amount of time for the trigger level to be reached, any bytes already available are returned immediately, even if fewer than the trigger level.
+    /// When the timeout expires, whatever bytes were available are returned, which might be none.
+    /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
+    /// Analogous to [`xStreamBufferReceive`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/07-Stream-buffers/06-xStreamBufferReceive).
+    template<typename Rep, typename Period>
+    [[nodiscard]] std::span<uint8_t> receive(std::span<uint8_t> buffer, std::chrono::duration<Rep, Period> timeout);
+
+    /// Changes the amount of bytes that need to be available before a blocked reader is woken up and returns whether it was successful, which it isn't if the level is larger than `CAPACITY`.
+    /// Analogous to [`xStreamBufferSetTriggerLevel`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/07-Stream-buffers/15-xStreamBufferSetTriggerLevel).
+    [[nodiscard]] bool set_trigger_level(size_t);
+
+    /// Obtains the amount of bytes that can be read from the channel.
+    /// Analogous to [`xStreamBufferBytesAvailable`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/07-Stream-buffers/12-xStreamBufferBytesAvailable).
+    [[nodiscard]] size_t bytes_available() const;
+
+    /// Obtains the amount of bytes that can be written to the channel.
+    /// Analogous to [`xStreamBufferSpacesAvailable`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/07-Stream-buffers/13-xStreamBufferSpacesAvailable).
+    [[nodiscard]] size_t spaces_available() const;
+
+    /// Discards every byte in the channel and returns whether it was successful, which it isn't if a task is blocked on it.
+    /// Analogous to [`xStreamBufferReset`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/07-Stream-buffers/14-xStreamBufferReset).
+    [[nodiscard]] bool reset();
+
+    /// Queries the channel to determine if it is empty.
+    /// Analogous to [`xStreamBufferIsEmpty`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/07-Stream-buffers/10-xStreamBufferIsEmpty).
+    [[nodiscard]] bool is_empty() const;
+
+    /// Queries the channel to determine if it is full.
+    /// Analogous to [`xStreamBufferIsFull`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/07-Stream-buffers/11-xStreamBufferIsFull).
+    [[nodiscard]] bool is_full() const;
+
+    /// Obtains the raw handle backing this channel.
+    [[nodiscard]] StreamBufferHandle_t raw_handle() const;
+
+    /// Creates an ISR-safe version of the channel.
+    [[nodiscard]] isr::StreamChannel for_isr();
+
+private:
+    StreamBufferHandle_t m_handle { nullptr };
+    StaticStreamBuffer_t m_static_stream_buffer;
+    // FreeRTOS needs one extra byte to tell a full buffer apart from an empty one.
+    std::array<uint8_t, CAPACITY + 1> m_static_storage;
+};
+
+template<size_t CAPACITY>
+StreamChannel<CAPACITY>::~StreamChannel() {
+    if (m_handle)
+        destroy();
+}
+
+template<size_t CAPACITY>
+void StreamChannel<CAPACITY>::create(size_t trigger_level) {
+    configASSERT(m_handle == nullptr);
+    configASSERT(trigger_level > 0 and trigger_level <= CAPACITY);
+    m_handle = xStreamBufferCreateStatic(m_static_storage.size(), trigger_level, m_static_storage.data(), &m_static_stream_buffer);
+}
+
+template<size_t CAPACITY>
+void StreamChannel<CAPACITY>::destroy() {
+    configASSERT(m_handle);
+    vStreamBufferDelete(std::exchange(m_handle, nullptr));
+}
+
+template<size_t CAPACITY>
+void StreamChannel<CAPACITY>::await_send(std::span<const uint8_t> bytes) {
+    while (not bytes.empty())
+        bytes = bytes.subspan(send(bytes, time::FOREVER));
+}
+
+template<size_t CAPACITY>
+template<typename Rep, typename Period>
+size_t StreamChannel<CAPACITY>::send(std::span<const uint8_t> bytes, std::chrono::duration<Rep, Period> timeout) {
+    return xStreamBufferSend(m_handle, bytes.data(), bytes.size(), time::to_raw_tick(timeout));
+}
+
+template<size_t CAPACITY>
+std::span<uint8_t> StreamChannel<CAPACITY>::await_receive(std::span<uint8_t> buffer) {
+    return receive(buffer, time::FOREVER);
+}
+
+template<size_t CAPACITY>
+template<typename Rep, typename Period>
+std::span<uint8_t> StreamChannel<CAPACITY>::receive(std::span<uint8_t> buffer, std::chrono::duration<Rep, Period> timeout) {
+    return buffer.first(xStreamBufferReceive(m_handle, buffer.data(), buffer.size(), time::to_raw_tick(timeout)));
+}
+
+template<size_t CAPACITY>
+bool StreamChannel<CAPACITY>::set_trigger_level(size_t trigger_level) {
+    return xStreamBufferSetTriggerLevel(m_handle, trigger_level) == pdTRUE;
+}
+
+template<size_t CAPACITY>
+size_t StreamChannel<CAPACITY>::bytes_available() const {
+    return xStreamBufferBytesAvailable(m_handle);
+}
+
+template<size_t CAPACITY>
+size_t StreamChannel<CAPACITY>::spaces_available() const {
+    return xStreamBufferSpacesAvailable(m_handle);
+}
+
+template<size_t CAPACITY>
+bool StreamChannel<CAPACITY>::reset() {
+    return xStreamBufferReset(m_handle) == pdPASS;
+}
+
+template<size_t CAPACITY>
+bool StreamChannel<CAPACITY>::is_empty() const {
+    return xStreamBufferIsEmpty(m_handle) == pdTRUE;
+}
+
+template<size_t CAPACITY>
+bool StreamChannel<CAPACITY>::is_full() const {
+    return xStreamBufferIsFull(m_handle) == pdTRUE;
+}
+
+template<size_t CAPACITY>
+StreamBufferHandle_t StreamChannel<CAPACITY>::raw_handle() const {
+    return m_handle;
+}
+
+template<size_t CAPACITY>
+isr::StreamChannel StreamChannel<CAPACITY>::for_isr() {
+    return isr::StreamChannel { m_handle };
+}
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <optional>
+
+#include <xf/isr/isr.hpp>
+
+namespace xf::queue {
+template<typename T, size_t BUFFERS>
+class PingPong;
+}
+
+namespace xf::queue::isr {
+
+/// An ISR-safe version of the producer side of `PingPong`, obtained by calling `PingPong::for_isr()`.
+template<typename T, size_t BUFFERS>
+class PingPong {
+public:
+    /// Constructs a new ISR-safe view of the given ping-pong buffers.
+    explicit PingPong(queue::PingPong<T, BUFFERS>& ping_pong)
+        : m_ping_pong(ping_pong) { }
+
+    /// Obtains the buffer the producer is currently filling.
+    [[nodiscard]] T& back() { return m_ping_pong.back(); }
+
+    /// Hands the back buffer to the consumer and moves on to the next free one, returning whether there was one and, if so, whether a context switch needs to be performed.
+    /// When there isn't, the back buffer is kept, it's contents are dropped and an overrun is counted.
+    [[nodiscard]] std::optional<xf::isr::HigherPriorityTaskWoken> publish() {
+        const auto next = m_ping_pong.m_free.for_isr().receive();
+        if (not next) {
+            m_ping_pong.m_overruns.fetch_add(1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+
+        // There is always room: every index is in exactly one place at a time.
+        const auto sent = m_ping_pong.m_ready.for_isr().send(m_ping_pong.m_back);
+        m_ping_pong.m_back = next->item;
+        return next->higher_priority_task_woken or sent.value_or(false);
+    }
+
+private:
+    queue::PingPong<T, BUFFERS>& m_ping_pong;
+};
+
+}
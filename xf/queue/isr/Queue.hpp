@@ -4,7 +4,10 @@
 #include <cstddef>
 #include <optional>
 
+#include <xf/config.hpp>
+#include <xf/isr/Probe.hpp>
 #include <xf/isr/isr.hpp>
+#include <xf/queue/QueueCore.hpp>
 
 namespace xf::queue::isr {
 
@@ -18,6 +21,11 @@ public:
     /// Constructs a new ISR-safe queue from the given handle.
     explicit Queue(QueueHandle_t);
 
+#if XF_QUEUE_DWELL_TIME
+    /// Constructs a new ISR-safe queue from the given handle, recording how long received items waited in the queue into the histogram of `core`.
+    Queue(QueueHandle_t, const QueueCore& core);
+#endif
+
     /// Tries pushing an item to the back of the queue and returns whether it was successful and, if so, whether a context switch needs to be performed.
     /// Analogous to [`xQueueSendFromISR`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/06-Queues/04-xQueueSendFromISR).
     [[nodiscard]] std::optional<xf::isr::HigherPriorityTaskWoken> send(const Item&) const;
@@ -59,10 +67,22 @@ public:
     [[nodiscard]] bool is_full() const;
 
 private:
+#if XF_QUEUE_DWELL_TIME
+    using StoredItem = detail::Enqueued<Item>;
+#else
+    using StoredItem = Item;
+#endif
+
     std::optional<xf::isr::HigherPriorityTaskWoken> generic_send(const Item&, BaseType_t copy_position) const;
 
+    // Extracts the item out of the stored one, recording how long it waited in the queue if it was `received` (as opposed to peeked).
+    Item unstamp(const StoredItem&, bool received) const;
+
 private:
     QueueHandle_t m_handle;
+#if XF_QUEUE_DWELL_TIME
+    const QueueCore* m_core { nullptr };
+#endif
 };
 
 template<typename Item>
@@ -70,6 +90,16 @@ Queue<Item>::Queue(QueueHandle_t handle)
     : m_handle(handle) {
 }
 
+#if XF_QUEUE_DWELL_TIME
+
+template<typename Item>
+Queue<Item>::Queue(QueueHandle_t handle, const QueueCore& core)
+    : m_handle(handle)
+    , m_core(&core) {
+}
+
+#endif
+
 template<typename Item>
 std::optional<xf::isr::HigherPriorityTaskWoken> Queue<Item>::send(const Item& item) const {
     return send_to_back(item);
@@ -88,11 +118,11 @@ std::optional<xf::isr::HigherPriorityTaskWoken> Queue<Item>::send_to_front(const
 template<typename Item>
 std::optional<typename Queue<Item>::ReceiveData> Queue<Item>::receive() {
     BaseType_t higher_priority_task_woken = pdFALSE;
-    alignas(Item) std::byte buffer[sizeof(Item)];
+    alignas(StoredItem) std::byte buffer[sizeof(StoredItem)];
     if (xQueueReceiveFromISR(m_handle, &buffer, &higher_priority_task_woken) != pdTRUE)
         return std::nullopt;
 
-    return { std::bit_cast<Item>(buffer), higher_priority_task_woken };
+    return ReceiveData { unstamp(std::bit_cast<StoredItem>(buffer), true), higher_priority_task_woken != pdFALSE };
 }
 
 template<typename Item>
@@ -104,11 +134,11 @@ xf::isr::HigherPriorityTaskWoken Queue<Item>::overwrite(const Item& item) {
 template<typename Item>
 std::optional<typename Queue<Item>::ReceiveData> Queue<Item>::peek() {
     BaseType_t higher_priority_task_woken = pdFALSE;
-    alignas(Item) std::byte buffer[sizeof(Item)];
+    alignas(StoredItem) std::byte buffer[sizeof(StoredItem)];
     if (xQueuePeekFromISR(m_handle, &buffer) != pdTRUE)
         return std::nullopt;
 
-    return { std::bit_cast<Item>(buffer), higher_priority_task_woken };
+    return ReceiveData { unstamp(std::bit_cast<StoredItem>(buffer), false), higher_priority_task_woken != pdFALSE };
 }
 
 template<typename Item>
@@ -129,9 +159,27 @@ bool Queue<Item>::is_full() const {
 template<typename Item>
 std::optional<xf::isr::HigherPriorityTaskWoken> Queue<Item>::generic_send(const Item& item, BaseType_t copy_position) const {
     BaseType_t higher_priority_task_woken = pdFALSE;
-    if (xQueueGenericSendFromISR(m_handle, &item, &higher_priority_task_woken, copy_position) != pdTRUE)
+#if XF_QUEUE_DWELL_TIME
+    const StoredItem stored { time::CycleClock::now().time_since_epoch().count(), item };
+#else
+    const StoredItem& stored = item;
+#endif
+    if (xQueueGenericSendFromISR(m_handle, &stored, &higher_priority_task_woken, copy_position) != pdTRUE)
         return std::nullopt;
+
+    xf::isr::Probe::stamp_wake();
     return higher_priority_task_woken;
 }
 
+template<typename Item>
+Item Queue<Item>::unstamp(const StoredItem& stored, [[maybe_unused]] bool received) const {
+#if XF_QUEUE_DWELL_TIME
+    if (received and m_core)
+        m_core->record_dwell(stored.sent);
+    return stored.item;
+#else
+    return stored;
+#endif
+}
+
 }
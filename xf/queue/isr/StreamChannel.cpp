@@ -0,0 +1,33 @@
+#include "StreamChannel.hpp"
+
+#include <xf/isr/Probe.hpp>
+
+namespace xf::queue::isr {
+
+StreamChannel::StreamChannel(StreamBufferHandle_t handle)
+    : m_handle(handle) {
+}
+
+StreamChannel::SendData StreamChannel::send(std::span<const uint8_t> bytes) {
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    const size_t bytes_sent = xStreamBufferSendFromISR(m_handle, bytes.data(), bytes.size(), &higher_priority_task_woken);
+    if (bytes_sent > 0)
+        xf::isr::Probe::stamp_wake();
+    return SendData { bytes_sent, higher_priority_task_woken != pdFALSE };
+}
+
+StreamChannel::ReceiveData StreamChannel::receive(std::span<uint8_t> buffer) {
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    const size_t bytes_received = xStreamBufferReceiveFromISR(m_handle, buffer.data(), buffer.size(), &higher_priority_task_woken);
+    return ReceiveData { buffer.first(bytes_received), higher_priority_task_woken != pdFALSE };
+}
+
+size_t StreamChannel::bytes_available() const {
+    return xStreamBufferBytesAvailable(m_handle);
+}
+
+size_t StreamChannel::spaces_available() const {
+    return xStreamBufferSpacesAvailable(m_handle);
+}
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/stream_buffer.h>
+
+#include <xf/isr/isr.hpp>
+
+namespace xf::queue::isr {
+
+/// An ISR-safe version of `StreamChannel`, obtained by calling `StreamChannel::for_isr()`.
+class StreamChannel {
+public:
+    /// Constructs a new ISR-safe channel from the given handle.
+    explicit StreamChannel(StreamBufferHandle_t);
+
+    struct SendData {
+        size_t bytes_sent;
+        xf::isr::HigherPriorityTaskWoken higher_priority_task_woken;
+    };
+
+    /// Writes as many of the bytes as fit in the channel and returns how many were written alongside whether a context switch needs to be performed.
+    /// The reader is only woken up once the trigger level is reached, so a DMA or UART ISR can forward every chunk it gets without waking the reader for each of them.
+    /// Analogous to [`xStreamBufferSendFromISR`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/07-Stream-buffers/05-xStreamBufferSendFromISR).
+    [[nodiscard]] SendData send(std::span<const uint8_t> bytes);
+
+    struct ReceiveData {
+        std::span<uint8_t> bytes;
+        xf::isr::HigherPriorityTaskWoken higher_priority_task_woken;
+    };
+
+    /// Reads as many bytes as are available and fit in the buffer and returns the part of it that was filled alongside whether a context switch needs to be performed.
+    /// Analogous to [`xStreamBufferReceiveFromISR`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/07-Stream-buffers/07-xStreamBufferReceiveFromISR).
+    [[nodiscard]] ReceiveData receive(std::span<uint8_t> buffer);
+
+    /// Obtains the amount of bytes that can be read from the channel.
+    /// Analogous to [`xStreamBufferBytesAvailable`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/07-Stream-buffers/12-xStreamBufferBytesAvailable).
+    [[nodiscard]] size_t bytes_available() const;
+
+    /// Obtains the amount of bytes that can be written to the channel.
+    /// Analogous to [`xStreamBufferSpacesAvailable`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/07-Stream-buffers/13-xStreamBufferSpacesAvailable).
+    [[nodiscard]] size_t spaces_available() const;
+
+private:
+    StreamBufferHandle_t m_handle;
+};
+
+}
@@ -7,6 +7,7 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
 
+#include <xf/sync/WaitGraph.hpp>
 #include <xf/time/time.hpp>
 
 namespace xf::semaphore {
@@ -64,6 +65,9 @@ public:
     [[nodiscard]] Handle raw_handle();
 
 private:
+    /// Takes the mutex, registering the calling task as blocked on it in the meantime.
+    [[nodiscard]] bool take(TickType_t ticks) const;
+
     T m_value;
 
     Handle m_handle;
@@ -118,7 +122,7 @@ R MutexProtected<T>::await_access(FN&& callback) const {
 template<typename T>
 template<std::invocable<T&> FN, typename Rep, typename Period, typename R>
 std::optional<std::conditional_t<std::is_void_v<R>, std::monostate, R>> MutexProtected<T>::access(FN&& callback, std::chrono::duration<Rep, Period> timeout) {
-    if (xSemaphoreTake(m_handle, time::to_raw_tick(timeout)) != pdTRUE)
+    if (not take(time::to_raw_tick(timeout)))
         return std::nullopt;
 
     if constexpr (std::is_void_v<R>) {
@@ -139,7 +143,7 @@ std::optional<std::conditional_t<std::is_void_v<R>, std::monostate, R>> MutexPro
 template<typename T>
 template<std::invocable<const T&> FN, typename Rep, typename Period, typename R>
 std::optional<std::conditional_t<std::is_void_v<R>, std::monostate, R>> MutexProtected<T>::access(FN&& callback, std::chrono::duration<Rep, Period> timeout) const {
-    if (xSemaphoreTake(m_handle, time::to_raw_tick(timeout)) != pdTRUE)
+    if (not take(time::to_raw_tick(timeout)))
         return std::nullopt;
 
     if constexpr (std::is_void_v<R>) {
@@ -159,6 +163,12 @@ std::optional<std::conditional_t<std::is_void_v<R>, std::monostate, R>> MutexPro
     }
 }
 
+template<typename T>
+bool MutexProtected<T>::take(TickType_t ticks) const {
+    sync::wait_graph::Blocked blocked { sync::wait_graph::Kind::Mutex, m_handle };
+    return xSemaphoreTake(m_handle, ticks) == pdTRUE;
+}
+
 template<typename T>
 Handle MutexProtected<T>::raw_handle() {
     return m_handle;
@@ -0,0 +1,38 @@
+#include "Barrier.hpp"
+
+namespace xf::sync {
+
+Barrier::Barrier(uint32_t parties)
+    : m_parties(parties) {
+    configASSERT(parties > 0);
+}
+
+bool Barrier::await_arrive_and_wait() {
+    Waiter waiter;
+    Waiter* round = nullptr;
+    const bool last = m_lock.locked([&] {
+        if (++m_arrived < m_parties) {
+            m_waiters.push(waiter);
+            return false;
+        }
+
+        // Only the tasks of this round can be in the list, since none of them can arrive again before being woken
+        m_arrived = 0;
+        round = m_waiters.pop_all();
+        return true;
+    });
+
+    if (last) {
+        WaitList::wake(round);
+        return true;
+    }
+
+    (void)m_waiters.wait(m_lock, waiter, portMAX_DELAY);
+    return false;
+}
+
+uint32_t Barrier::parties() const {
+    return m_parties;
+}
+
+}
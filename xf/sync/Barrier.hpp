@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+#include "CriticalSection.hpp"
+#include "WaitList.hpp"
+
+namespace xf::sync {
+
+/// A reusable rendezvous point for a fixed amount of tasks, e.g: to have every task reach the end of a processing phase before any of them starts the next one.
+/// Every task but the last one to arrive is kept in a `WaitList` and woken through it's notification at `XF_SYNC_NOTIFICATION_INDEX`, avoiding kernel objects entirely. The barrier resets itself as soon as the last task arrives, so it can be used in a loop.
+/// Analogous to [`xEventGroupSync`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/12-Event-groups-or-flags/09-xEventGroupSync) and [`std::barrier`](https://en.cppreference.com/w/cpp/thread/barrier).
+class Barrier {
+public:
+    /// Constructs a new barrier for the given amount of tasks, which must be at least one.
+    explicit Barrier(uint32_t parties);
+
+    /// Arrives at the barrier and waits indefinitely for every other task to arrive as well.
+    /// Returns `true` for exactly one task of each round - the last one to arrive - which can be used to elect a task to do some work between rounds.
+    bool await_arrive_and_wait();
+
+    /// Obtains the amount of tasks the barrier waits for.
+    [[nodiscard]] uint32_t parties() const;
+
+private:
+    const uint32_t m_parties;
+    uint32_t m_arrived { 0 };
+    CriticalSection m_lock;
+    WaitList m_waiters;
+};
+
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <concepts>
+#include <functional>
+#include <type_traits>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+namespace xf::sync {
+
+/// A short critical section protecting data that is shared between tasks and ISRs, on every core.
+/// On ESP-IDF it is backed by a `portMUX_TYPE` spinlock, elsewhere it masks interrupts (and therefore the scheduler) for it's whole duration.
+/// Code running inside a critical section must be short and must never block, call into the kernel or otherwise wait.
+/// See https://www.freertos.org/Documentation/02-Kernel/04-API-references/04-RTOS-kernel-control/01-taskENTER_CRITICAL_taskEXIT_CRITICAL for more information on how FreeRTOS critical sections work.
+class CriticalSection {
+public:
+    /// Invokes the callback inside the critical section and returns the return value of the callback.
+    /// Must only be called from a task.
+    /// Analogous to [`taskENTER_CRITICAL`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/04-RTOS-kernel-control/01-taskENTER_CRITICAL_taskEXIT_CRITICAL).
+    template<std::invocable FN>
+    std::invoke_result_t<FN> locked(FN&& callback);
+
+    /// Invokes the callback inside the critical section and returns the return value of the callback.
+    /// Must only be called from an ISR.
+    /// Analogous to [`taskENTER_CRITICAL_FROM_ISR`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/04-RTOS-kernel-control/02-taskENTER_CRITICAL_FROM_ISR_taskEXIT_CRITICAL_FROM_ISR).
+    template<std::invocable FN>
+    std::invoke_result_t<FN> locked_from_isr(FN&& callback);
+
+private:
+#if ESP_PLATFORM
+    portMUX_TYPE m_mux = portMUX_INITIALIZER_UNLOCKED;
+#endif
+};
+
+template<std::invocable FN>
+std::invoke_result_t<FN> CriticalSection::locked(FN&& callback) {
+    struct Guard {
+#if ESP_PLATFORM
+        explicit Guard(portMUX_TYPE& mux)
+            : mux(mux) { taskENTER_CRITICAL(&mux); }
+        ~Guard() { taskEXIT_CRITICAL(&mux); }
+
+        portMUX_TYPE& mux;
+#else
+        Guard() { taskENTER_CRITICAL(); }
+        ~Guard() { taskEXIT_CRITICAL(); }
+#endif
+    };
+
+#if ESP_PLATFORM
+    Guard guard { m_mux };
+#else
+    Guard guard;
+#endif
+    return std::invoke(std::forward<FN>(callback));
+}
+
+template<std::invocable FN>
+std::invoke_result_t<FN> CriticalSection::locked_from_isr(FN&& callback) {
+    struct Guard {
+#if ESP_PLATFORM
+        explicit Guard(portMUX_TYPE& mux)
+            : mux(mux) { taskENTER_CRITICAL_ISR(&mux); }
+        ~Guard() { taskEXIT_CRITICAL_ISR(&mux); }
+
+        portMUX_TYPE& mux;
+#else
+        Guard()
+            : saved_interrupt_status(taskENTER_CRITICAL_FROM_ISR()) { }
+        ~Guard() { taskEXIT_CRITICAL_FROM_ISR(saved_interrupt_status); }
+
+        UBaseType_t saved_interrupt_status;
+#endif
+    };
+
+#if ESP_PLATFORM
+    Guard guard { m_mux };
+#else
+    Guard guard;
+#endif
+    return std::invoke(std::forward<FN>(callback));
+}
+
+}
@@ -0,0 +1,65 @@
+#include "Latch.hpp"
+
+namespace xf::sync {
+
+Latch::Latch(uint32_t count)
+    : m_count(count) {
+}
+
+void Latch::count_down(uint32_t n) {
+    const uint32_t previous = m_count.fetch_sub(n, std::memory_order_acq_rel);
+    configASSERT(previous >= n);
+    if (previous != n)
+        return;
+
+    // Waiters check the count inside the critical section before being pushed, so every one of them that saw a non-zero count is already in the list.
+    WaitList::wake(m_lock.locked([&]() -> Waiter* {
+        if (m_count.load(std::memory_order_relaxed) != 0)
+            return nullptr;
+        return m_waiters.pop_all();
+    }));
+}
+
+bool Latch::try_wait() const {
+    return m_count.load(std::memory_order_acquire) == 0;
+}
+
+void Latch::await_wait() {
+    (void)wait_raw(portMAX_DELAY);
+}
+
+void Latch::await_arrive_and_wait() {
+    count_down();
+    await_wait();
+}
+
+uint32_t Latch::count() const {
+    return m_count.load(std::memory_order_relaxed);
+}
+
+void Latch::add(uint32_t n) {
+    m_count.fetch_add(n, std::memory_order_relaxed);
+}
+
+bool Latch::wait_raw(TickType_t ticks) {
+    if (try_wait())
+        return true;
+
+    if (ticks == 0)
+        return false;
+
+    Waiter waiter;
+    const bool reached_zero = m_lock.locked([&] {
+        if (m_count.load(std::memory_order_acquire) == 0)
+            return true;
+
+        m_waiters.push(waiter);
+        return false;
+    });
+    if (reached_zero)
+        return true;
+
+    return m_waiters.wait(m_lock, waiter, ticks);
+}
+
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include <freertos/FreeRTOS.h>
+
+#include "CriticalSection.hpp"
+#include "WaitList.hpp"
+#include <xf/time/time.hpp>
+
+namespace xf::sync {
+
+/// A single-use countdown that tasks can wait on until it reaches zero, e.g: to wait until a set of workers have finished initializing.
+/// The count is an atomic, so counting down without reaching zero and checking whether it has reached zero never enter the kernel nor the critical section.
+/// Tasks that do have to block are kept in a `WaitList` and woken all at once through their notification at `XF_SYNC_NOTIFICATION_INDEX` when the count reaches zero.
+/// Analogous to [`std::latch`](https://en.cppreference.com/w/cpp/thread/latch).
+class Latch {
+public:
+    /// Constructs a new latch with the given count.
+    explicit Latch(uint32_t count);
+
+    /// Decrements the count by `n`, which must not be greater than the count itself, waking every waiter if it reaches zero. Must only be called from a task.
+    void count_down(uint32_t n = 1);
+
+    /// Returns whether the count has reached zero, without waiting.
+    [[nodiscard]] bool try_wait() const;
+
+    /// Waits indefinitely for the count to reach zero.
+    void await_wait();
+
+    /// Waits up to `timeout` amount of time for the count to reach zero and returns whether it did.
+    /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
+    template<typename Rep, typename Period>
+    [[nodiscard]] bool wait(std::chrono::duration<Rep, Period> timeout);
+
+    /// Decrements the count by one and then waits indefinitely for it to reach zero.
+    void await_arrive_and_wait();
+
+    /// Obtains the current count.
+    [[nodiscard]] uint32_t count() const;
+
+protected:
+    /// Increments the count by `n`.
+    void add(uint32_t n);
+
+private:
+    bool wait_raw(TickType_t ticks);
+
+    std::atomic<uint32_t> m_count;
+    CriticalSection m_lock;
+    WaitList m_waiters;
+};
+
+template<typename Rep, typename Period>
+bool Latch::wait(std::chrono::duration<Rep, Period> timeout) {
+    return wait_raw(time::to_raw_tick(timeout));
+}
+
+}
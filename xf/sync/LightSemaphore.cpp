@@ -0,0 +1,82 @@
+#include "LightSemaphore.hpp"
+
+namespace xf::sync {
+
+LightSemaphore::LightSemaphore(uint32_t initial_count)
+    : m_count(initial_count) {
+}
+
+void LightSemaphore::await_take() {
+    (void)take_raw(portMAX_DELAY);
+}
+
+bool LightSemaphore::try_take() {
+    uint32_t count = m_count.load(std::memory_order_relaxed);
+    while (count > 0) {
+        if (m_count.compare_exchange_weak(count, count - 1, std::memory_order_acquire, std::memory_order_relaxed))
+            return true;
+    }
+    return false;
+}
+
+void LightSemaphore::give() {
+    WaitList::wake(hand_off(false));
+}
+
+uint32_t LightSemaphore::count() const {
+    return m_count.load(std::memory_order_relaxed);
+}
+
+isr::LightSemaphore LightSemaphore::for_isr() {
+    return isr::LightSemaphore { *this };
+}
+
+bool LightSemaphore::take_raw(TickType_t ticks) {
+    if (try_take())
+        return true;
+
+    if (ticks == 0)
+        return false;
+
+    Waiter waiter;
+    // `m_waiting` is raised before the count is checked again, while `give()` raises the count before checking `m_waiting`.
+    // Both being sequentially consistent, at least one of the sides sees the other and the permit can't be missed.
+    const bool taken = m_lock.locked([&] {
+        m_waiting.fetch_add(1, std::memory_order_seq_cst);
+        uint32_t count = m_count.load(std::memory_order_seq_cst);
+        while (count > 0) {
+            if (m_count.compare_exchange_weak(count, count - 1, std::memory_order_seq_cst)) {
+                m_waiting.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        m_waiters.push(waiter);
+        return false;
+    });
+    if (taken)
+        return true;
+
+    if (m_waiters.wait(m_lock, waiter, ticks))
+        return true;
+
+    m_waiting.fetch_sub(1, std::memory_order_relaxed);
+    return false;
+}
+
+// Takes back the permit that was just given and pops a waiter to hand it to, if there is any waiter left to take it.
+Waiter* LightSemaphore::hand_off(bool from_isr) {
+    m_count.fetch_add(1, std::memory_order_seq_cst);
+    if (m_waiting.load(std::memory_order_seq_cst) == 0)
+        return nullptr;
+
+    auto pop = [&]() -> Waiter* {
+        if (m_waiters.is_empty() or not try_take())
+            return nullptr;
+
+        m_waiting.fetch_sub(1, std::memory_order_relaxed);
+        return m_waiters.pop();
+    };
+    return from_isr ? m_lock.locked_from_isr(pop) : m_lock.locked(pop);
+}
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include <freertos/FreeRTOS.h>
+
+#include "CriticalSection.hpp"
+#include "WaitList.hpp"
+#include "isr/LightSemaphore.hpp"
+#include <xf/time/time.hpp>
+
+namespace xf::sync {
+
+/// A counting semaphore that doesn't use a kernel object.
+/// The count is an atomic, so taking an available permit or giving one back while nobody waits is a single compare-and-swap that never enters the kernel.
+/// Tasks that do have to block are kept in a priority-ordered `WaitList` and handed permits directly, highest priority first, through their notification at `XF_SYNC_NOTIFICATION_INDEX`.
+/// Unlike kernel mutexes, there is no priority inheritance, so use `MutexProtected` to guard data instead.
+class LightSemaphore {
+public:
+    /// Constructs a new semaphore with the given amount of permits available.
+    explicit LightSemaphore(uint32_t initial_count = 0);
+
+    /// Takes a permit, waiting indefinitely for one to become available.
+    /// Analogous to [`xSemaphoreTake`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/10-Semaphore-and-Mutexes/12-xSemaphoreTake) with `portMAX_DELAY` as the timeout.
+    void await_take();
+
+    /// Tries taking a permit, waiting for up to `timeout` for one to become available, and returns whether it was successful.
+    /// Analogous to [`xSemaphoreTake`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/10-Semaphore-and-Mutexes/12-xSemaphoreTake).
+    /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
+    template<typename Rep, typename Period>
+    [[nodiscard]] bool take(std::chrono::duration<Rep, Period> timeout);
+
+    /// Tries taking a permit without waiting and returns whether it was successful.
+    [[nodiscard]] bool try_take();
+
+    /// Gives a permit back, handing it directly to the highest priority waiter if there is one.
+    /// Analogous to [`xSemaphoreGive`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/10-Semaphore-and-Mutexes/15-xSemaphoreGive).
+    void give();
+
+    /// Obtains the amount of permits currently available.
+    /// Analogous to [`uxSemaphoreGetCount`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/10-Semaphore-and-Mutexes/18-uxSemaphoreGetCount).
+    [[nodiscard]] uint32_t count() const;
+
+    /// Obtains an ISR-safe view of the semaphore.
+    [[nodiscard]] isr::LightSemaphore for_isr();
+
+private:
+    friend class isr::LightSemaphore;
+
+    bool take_raw(TickType_t ticks);
+    Waiter* hand_off(bool from_isr);
+
+    std::atomic<uint32_t> m_count;
+    std::atomic<uint32_t> m_waiting { 0 };
+    CriticalSection m_lock;
+    WaitList m_waiters;
+};
+
+template<typename Rep, typename Period>
+bool LightSemaphore::take(std::chrono::duration<Rep, Period> timeout) {
+    return take_raw(time::to_raw_tick(timeout));
+}
+
+}
@@ -0,0 +1,176 @@
+#include "WaitGraph.hpp"
+
+#if XF_WAIT_GRAPH
+
+#    include <array>
+
+#    include <freertos/semphr.h>
+
+#    include "CriticalSection.hpp"
+
+namespace xf::sync::wait_graph {
+
+namespace {
+
+struct Slot {
+    TaskHandle_t task { nullptr };
+    Kind kind;
+    const void* resource;
+    UBaseType_t priority;
+    TickType_t since;
+};
+
+struct Party {
+    TaskHandle_t task { nullptr };
+    UBaseType_t priority { 0 };
+};
+
+struct Counterparts {
+    const void* resource { nullptr };
+    Party producer;
+    Party consumer;
+};
+
+constexpr size_t NONE = XF_WAIT_GRAPH_TASKS;
+
+CriticalSection s_lock;
+std::array<Slot, XF_WAIT_GRAPH_TASKS> s_slots;
+std::array<Counterparts, XF_WAIT_GRAPH_RESOURCES> s_resources;
+size_t s_oldest_resource { 0 };
+uint32_t s_untracked { 0 };
+
+}
+
+size_t detail::enter(Kind kind, const void* resource) {
+    const Slot slot { xTaskGetCurrentTaskHandle(), kind, resource, uxTaskPriorityGet(nullptr), xTaskGetTickCount() };
+    return s_lock.locked([&] {
+        for (size_t i = 0; i < s_slots.size(); ++i) {
+            if (s_slots[i].task == nullptr) {
+                s_slots[i] = slot;
+                return i;
+            }
+        }
+        ++s_untracked;
+        return NONE;
+    });
+}
+
+void detail::leave(size_t slot) {
+    if (slot == NONE)
+        return;
+
+    s_lock.locked([&] { s_slots[slot].task = nullptr; });
+}
+
+void detail::note(const void* resource, bool producer) {
+    const Party party { xTaskGetCurrentTaskHandle(), uxTaskPriorityGet(nullptr) };
+    s_lock.locked([&] {
+        auto* entry = &s_resources[s_oldest_resource];
+        for (auto& candidate : s_resources) {
+            if (candidate.resource == resource) {
+                entry = &candidate;
+                break;
+            }
+        }
+
+        if (entry->resource != resource) {
+            s_oldest_resource = (s_oldest_resource + 1) % s_resources.size();
+            *entry = Counterparts { resource, {}, {} };
+        }
+
+        (producer ? entry->producer : entry->consumer) = party;
+    });
+}
+
+Report detail::analyze(TickType_t min_inversion) {
+    const TickType_t now = xTaskGetTickCount();
+
+    Report report;
+    std::array<Slot, XF_WAIT_GRAPH_TASKS> slots;
+    std::array<Party, XF_WAIT_GRAPH_TASKS> holders {};
+
+    // Everything is copied at once so the graph is consistent, mutex holders are only resolved afterwards since that calls into the kernel.
+    s_lock.locked([&] {
+        slots = s_slots;
+        report.untracked = s_untracked;
+
+        for (size_t i = 0; i < slots.size(); ++i) {
+            if (slots[i].task == nullptr or slots[i].kind == Kind::Mutex or slots[i].kind == Kind::Primitive)
+                continue;
+
+            for (const auto& entry : s_resources) {
+                if (entry.resource == slots[i].resource) {
+                    holders[i] = slots[i].kind == Kind::QueueSend ? entry.consumer : entry.producer;
+                    break;
+                }
+            }
+        }
+    });
+
+    std::array<Wait, XF_WAIT_GRAPH_TASKS> waits;
+    for (size_t i = 0; i < slots.size(); ++i) {
+        if (slots[i].task == nullptr)
+            continue;
+
+        if (slots[i].kind == Kind::Mutex) {
+            const auto holder = xSemaphoreGetMutexHolder(static_cast<SemaphoreHandle_t>(const_cast<void*>(slots[i].resource)));
+            if (holder)
+                holders[i] = Party { holder, uxTaskPriorityGet(holder) };
+        }
+
+        // A task that both sends to and receives from a queue isn't waiting on itself.
+        if (holders[i].task == slots[i].task)
+            holders[i] = Party {};
+
+        waits[i] = Wait { slots[i].task, holders[i].task, slots[i].kind, slots[i].resource, slots[i].priority, holders[i].priority, time::Duration { now - slots[i].since } };
+    }
+
+    // Link each wait to the wait of it's holder, if the holder is blocked too, and prefer the holder's up-to-date priority over the one noted when it last touched the resource.
+    std::array<size_t, XF_WAIT_GRAPH_TASKS> next;
+    next.fill(NONE);
+    for (size_t i = 0; i < slots.size(); ++i) {
+        if (slots[i].task == nullptr or waits[i].holder == nullptr)
+            continue;
+
+        for (size_t j = 0; j < slots.size(); ++j) {
+            if (slots[j].task == waits[i].holder) {
+                next[i] = j;
+                if (slots[i].kind != Kind::Mutex)
+                    waits[i].holder_priority = slots[j].priority;
+                break;
+            }
+        }
+    }
+
+    // Each task waits on at most one other task, so following the links for as many steps as there are slots either comes back around or doesn't.
+    // A cycle is only reported from it's lowest slot, so that it's reported once.
+    for (size_t start = 0; start < slots.size(); ++start) {
+        bool lowest = true;
+        size_t node = next[start];
+        for (size_t steps = 1; node != NONE and node != start and steps < slots.size(); ++steps) {
+            lowest = lowest and node > start;
+            node = next[node];
+        }
+        if (node != start or not lowest)
+            continue;
+
+        do {
+            (void)report.deadlocked.push_back(waits[node]);
+            node = next[node];
+        } while (node != start);
+    }
+
+    for (size_t i = 0; i < slots.size(); ++i) {
+        if (slots[i].task == nullptr or waits[i].holder == nullptr)
+            continue;
+
+        if (waits[i].holder_priority < waits[i].waiter_priority and waits[i].duration.count() >= min_inversion)
+            (void)report.inversions.push_back(waits[i]);
+    }
+
+    return report;
+}
+
+}
+
+#endif
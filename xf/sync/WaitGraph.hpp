@@ -0,0 +1,159 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include <xf/StaticVector.hpp>
+#include <xf/config.hpp>
+#include <xf/time/time.hpp>
+
+//! A debugging aid that detects deadlocks and priority inversions, enabled by `XF_WAIT_GRAPH`.
+//! Every blocking call in xf - `MutexProtected::access()`, `Queue` sends and receives, task notification waits and the `xf::sync` primitives - registers the calling task as blocked on its resource for as long as it waits.
+//! `analyze()` then builds the wait-for graph out of those waits, linking each blocked task to the task it is waiting on:
+//! - A mutex waits on the task holding it.
+//! - A send to a full queue waits on the task that last received from it, and a receive from an empty queue waits on the task that last sent to it.
+//! - A task notification waits on the task that last set or gave it.
+//! - The `xf::sync` primitives have no single holder, so their waits are tracked but never linked.
+//!
+//! Queues and notifications have no owner, so the last task on the other end is only the most likely one to unblock the waiter, and a reported cycle involving them is a strong hint rather than a proof.
+//! Nothing runs in the background, the graph is analyzed whenever `analyze()` is called, e.g: periodically from a low priority task or a `Timer`:
+//! ```cpp
+//! const auto report = xf::sync::wait_graph::analyze(50ms);
+//! for (const auto& wait : report.deadlocked)
+//!     printf("deadlock: %s -> %s\n", pcTaskGetName(wait.waiter), pcTaskGetName(wait.holder));
+//! ```
+//! ISRs never block, so the ISR-safe APIs are not tracked.
+
+namespace xf::sync::wait_graph {
+
+/// The kind of resource a task is blocked on.
+enum class Kind : uint8_t {
+    /// A mutex, held by the task that took it.
+    Mutex,
+    /// A full queue, which the task that last received from it is expected to make room in.
+    QueueSend,
+    /// An empty queue, which the task that last sent to it is expected to fill.
+    QueueReceive,
+    /// A task notification, which the task that last set or gave it is expected to set again.
+    Notification,
+    /// An `xf::sync` primitive, which has no single holder.
+    Primitive,
+};
+
+/// An edge of the wait-for graph: a task blocked on a resource held by another task.
+struct Wait {
+    /// The blocked task.
+    TaskHandle_t waiter;
+    /// The task holding the resource, or `nullptr` if it is unknown.
+    TaskHandle_t holder;
+    /// The kind of resource the task is blocked on.
+    Kind kind;
+    /// The resource the task is blocked on, e.g: the raw handle of a mutex or queue.
+    const void* resource;
+    /// The current priority of the blocked task.
+    UBaseType_t waiter_priority;
+    /// The priority of the holder, if any.
+    UBaseType_t holder_priority;
+    /// How long the task has been blocked for.
+    time::Duration duration;
+};
+
+/// The result of analyzing the wait-for graph.
+struct Report {
+    /// Every wait that is part of a cycle - tasks waiting on each other, none of them able to make progress - one cycle after the other, each in the order the tasks wait on each other.
+    StaticVector<Wait, XF_WAIT_GRAPH_TASKS> deadlocked;
+    /// Every wait of a task on a lower priority holder that has lasted for at least the requested amount of time.
+    /// A mutex holder inherits the priority of its waiters, so these are mostly waits on queues and notifications, which don't.
+    StaticVector<Wait, XF_WAIT_GRAPH_TASKS> inversions;
+    /// How many waits, since startup, weren't tracked because `XF_WAIT_GRAPH_TASKS` tasks were already blocked.
+    uint32_t untracked { 0 };
+};
+
+/// Registers the calling task as blocked on the given resource for as long as it's alive.
+/// Should be declared right before the blocking call, e.g:
+/// ```cpp
+/// xf::sync::wait_graph::Blocked blocked { xf::sync::wait_graph::Kind::Mutex, handle };
+/// xSemaphoreTake(handle, portMAX_DELAY);
+/// ```
+/// Does nothing when `XF_WAIT_GRAPH` is disabled.
+class Blocked {
+public:
+    Blocked(Kind, const void* resource);
+    ~Blocked();
+
+    Blocked(const Blocked&) = delete;
+    Blocked& operator=(const Blocked&) = delete;
+
+#if XF_WAIT_GRAPH
+private:
+    size_t m_slot;
+#endif
+};
+
+/// Records the calling task as the last one to have sent to or given the resource. Does nothing when `XF_WAIT_GRAPH` is disabled.
+void note_producer(const void* resource);
+
+/// Records the calling task as the last one to have received from the resource. Does nothing when `XF_WAIT_GRAPH` is disabled.
+void note_consumer(const void* resource);
+
+/// Builds the wait-for graph out of the tasks currently blocked and reports the deadlocks and the priority inversions that have lasted for at least `min_inversion` amount of time.
+/// Must only be called from a task. Always returns an empty report when `XF_WAIT_GRAPH` is disabled.
+/// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
+template<typename Rep, typename Period>
+[[nodiscard]] Report analyze(std::chrono::duration<Rep, Period> min_inversion);
+
+namespace detail {
+
+size_t enter(Kind, const void* resource);
+void leave(size_t slot);
+void note(const void* resource, bool producer);
+Report analyze(TickType_t min_inversion);
+
+}
+
+inline Blocked::Blocked(Kind kind, const void* resource)
+#if XF_WAIT_GRAPH
+    : m_slot(detail::enter(kind, resource))
+#endif
+{
+    (void)kind;
+    (void)resource;
+}
+
+inline Blocked::~Blocked() {
+#if XF_WAIT_GRAPH
+    detail::leave(m_slot);
+#endif
+}
+
+inline void note_producer(const void* resource) {
+#if XF_WAIT_GRAPH
+    detail::note(resource, true);
+#else
+    (void)resource;
+#endif
+}
+
+inline void note_consumer(const void* resource) {
+#if XF_WAIT_GRAPH
+    detail::note(resource, false);
+#else
+    (void)resource;
+#endif
+}
+
+template<typename Rep, typename Period>
+Report analyze(std::chrono::duration<Rep, Period> min_inversion) {
+#if XF_WAIT_GRAPH
+    return detail::analyze(time::to_raw_tick(min_inversion));
+#else
+    (void)min_inversion;
+    return {};
+#endif
+}
+
+}
@@ -0,0 +1,17 @@
+#include "WaitGroup.hpp"
+
+namespace xf::sync {
+
+WaitGroup::WaitGroup()
+    : Latch(0) {
+}
+
+void WaitGroup::add(uint32_t n) {
+    Latch::add(n);
+}
+
+void WaitGroup::done() {
+    count_down();
+}
+
+}
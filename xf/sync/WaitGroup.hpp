@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Latch.hpp"
+
+namespace xf::sync {
+
+/// A counter of pending pieces of work that tasks can wait on until it reaches zero, e.g: to wait until 4 workers have finished processing a request.
+/// Unlike `Latch` it can be reused: once the count has reached zero new work can be added with `add()`.
+/// Work must only be added while the count is non-zero or nobody is waiting, otherwise tasks that are being woken up may miss the count reaching zero.
+/// Analogous to Go's [`sync.WaitGroup`](https://pkg.go.dev/sync#WaitGroup).
+class WaitGroup : private Latch {
+public:
+    /// Constructs a new wait group with no pending work.
+    WaitGroup();
+
+    /// Adds `n` pieces of pending work.
+    void add(uint32_t n = 1);
+
+    /// Marks one piece of work as done, waking every waiter if it was the last one.
+    void done();
+
+    using Latch::await_wait;
+    using Latch::count;
+    using Latch::try_wait;
+    using Latch::wait;
+};
+
+}
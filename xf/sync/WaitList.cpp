@@ -0,0 +1,112 @@
+#include "WaitList.hpp"
+
+#include <utility>
+
+#include "WaitGraph.hpp"
+#include <xf/isr/Probe.hpp>
+
+namespace xf::sync {
+
+Waiter::Waiter()
+    : task(xTaskGetCurrentTaskHandle())
+    , priority(uxTaskPriorityGet(nullptr)) {
+    (void)xTaskNotifyStateClearIndexed(nullptr, XF_SYNC_NOTIFICATION_INDEX);
+    (void)ulTaskNotifyValueClearIndexed(nullptr, XF_SYNC_NOTIFICATION_INDEX, UINT32_MAX);
+}
+
+void WaitList::push(Waiter& waiter) {
+    auto** link = &m_head;
+    while (*link and (*link)->priority >= waiter.priority)
+        link = &(*link)->next;
+
+    waiter.next = std::exchange(*link, &waiter);
+}
+
+bool WaitList::remove(Waiter& waiter) {
+    for (auto** link = &m_head; *link; link = &(*link)->next) {
+        if (*link == &waiter) {
+            *link = std::exchange(waiter.next, nullptr);
+            return true;
+        }
+    }
+    return false;
+}
+
+Waiter* WaitList::pop() {
+    auto* waiter = m_head;
+    if (waiter == nullptr)
+        return nullptr;
+
+    m_head = std::exchange(waiter->next, nullptr);
+    waiter->woken = true;
+    return waiter;
+}
+
+Waiter* WaitList::pop_all() {
+    for (auto* waiter = m_head; waiter; waiter = waiter->next)
+        waiter->woken = true;
+
+    return std::exchange(m_head, nullptr);
+}
+
+bool WaitList::is_empty() const {
+    return m_head == nullptr;
+}
+
+// The waiter may return (and it's stack frame vanish) as soon as it is notified, so everything needed from it is read beforehand.
+void WaitList::wake(Waiter* chain) {
+    while (chain) {
+        auto* task = chain->task;
+        chain = chain->next;
+        (void)xTaskNotifyGiveIndexed(task, XF_SYNC_NOTIFICATION_INDEX);
+    }
+}
+
+xf::isr::HigherPriorityTaskWoken WaitList::wake_from_isr(Waiter* chain) {
+    if (chain)
+        xf::isr::Probe::stamp_wake();
+
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    while (chain) {
+        auto* task = chain->task;
+        chain = chain->next;
+        vTaskNotifyGiveIndexedFromISR(task, XF_SYNC_NOTIFICATION_INDEX, &higher_priority_task_woken);
+    }
+    return higher_priority_task_woken;
+}
+
+// A waiter that was woken must always consume it's notification before returning, otherwise the waker could still be reading it.
+bool WaitList::wait(CriticalSection& lock, Waiter& waiter, TickType_t ticks) {
+    wait_graph::Blocked blocked { wait_graph::Kind::Primitive, this };
+    const TickType_t start = xTaskGetTickCount();
+    TickType_t remaining = ticks;
+
+    while (true) {
+        if (ulTaskNotifyTakeIndexed(XF_SYNC_NOTIFICATION_INDEX, pdTRUE, remaining) != 0) {
+            if (lock.locked([&] { return waiter.woken; }))
+                return true;
+        } else {
+            const bool timed_out = lock.locked([&] {
+                if (waiter.woken)
+                    return false;
+
+                (void)remove(waiter);
+                return true;
+            });
+            if (timed_out)
+                return false;
+
+            // Woken right as the wait timed out, the notification is on it's way.
+            (void)ulTaskNotifyTakeIndexed(XF_SYNC_NOTIFICATION_INDEX, pdTRUE, portMAX_DELAY);
+            return true;
+        }
+
+        // Notified by someone else, keep waiting for whatever time is left.
+        if (ticks != portMAX_DELAY) {
+            const TickType_t elapsed = xTaskGetTickCount() - start;
+            remaining = elapsed < ticks ? ticks - elapsed : 0;
+        }
+    }
+}
+
+}
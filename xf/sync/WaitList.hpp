@@ -0,0 +1,62 @@
+#pragma once
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "CriticalSection.hpp"
+#include <xf/config.hpp>
+#include <xf/isr/isr.hpp>
+
+namespace xf::sync {
+
+static_assert(XF_SYNC_NOTIFICATION_INDEX != tskDEFAULT_INDEX_TO_NOTIFY, "`XF_SYNC_NOTIFICATION_INDEX` must not be the default notification index, raise `configTASK_NOTIFICATION_ARRAY_ENTRIES` to at least 2");
+
+/// A task blocked on a `WaitList`.
+/// Waiters live on the stack of the task that is waiting, so lists never need to allocate nor have a capacity.
+/// Constructing a waiter records the calling task and it's current priority, and clears any stale notification left at `XF_SYNC_NOTIFICATION_INDEX`.
+struct Waiter {
+    Waiter();
+
+    TaskHandle_t task;
+    UBaseType_t priority;
+    Waiter* next { nullptr };
+    bool woken { false };
+};
+
+/// A list of tasks blocked on a synchronization primitive, ordered by priority (and then by arrival).
+/// Waiters are woken through their task notification at `XF_SYNC_NOTIFICATION_INDEX`, avoiding kernel objects entirely.
+/// The list doesn't synchronize itself: every method but `wait()` and `wake()` must be called inside the critical section of the primitive that owns it.
+class WaitList {
+public:
+    /// Adds the waiter to the list, behind every waiter of higher or equal priority.
+    void push(Waiter&);
+
+    /// Removes the waiter from the list and returns whether it was in it.
+    bool remove(Waiter&);
+
+    /// Removes the highest priority waiter from the list and marks it as woken, returning `nullptr` if the list is empty.
+    /// The waiter must then be passed to `wake()`, outside of the critical section.
+    [[nodiscard]] Waiter* pop();
+
+    /// Removes every waiter from the list and marks them as woken, returning them as a chain linked through `Waiter::next`.
+    /// The chain must then be passed to `wake()`, outside of the critical section.
+    [[nodiscard]] Waiter* pop_all();
+
+    /// Returns whether the list has no waiters.
+    [[nodiscard]] bool is_empty() const;
+
+    /// Notifies every waiter in the chain returned by `pop()` or `pop_all()`. Must only be called from a task.
+    static void wake(Waiter* chain);
+
+    /// Notifies every waiter in the chain returned by `pop()` or `pop_all()` and returns whether a context switch needs to be performed. Must only be called from an ISR.
+    static xf::isr::HigherPriorityTaskWoken wake_from_isr(Waiter* chain);
+
+    /// Blocks the calling task for up to `ticks` until the waiter, which must have been pushed to this list, is woken, and returns whether it was.
+    /// `lock` must be the critical section protecting the list and must not be held by the caller.
+    [[nodiscard]] bool wait(CriticalSection& lock, Waiter&, TickType_t ticks);
+
+private:
+    Waiter* m_head { nullptr };
+};
+
+}
@@ -0,0 +1,19 @@
+#include "LightSemaphore.hpp"
+
+#include <xf/sync/LightSemaphore.hpp>
+
+namespace xf::sync::isr {
+
+LightSemaphore::LightSemaphore(sync::LightSemaphore& semaphore)
+    : m_semaphore(semaphore) {
+}
+
+bool LightSemaphore::try_take() {
+    return m_semaphore.try_take();
+}
+
+xf::isr::HigherPriorityTaskWoken LightSemaphore::give() {
+    return sync::WaitList::wake_from_isr(m_semaphore.hand_off(true));
+}
+
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <xf/isr/isr.hpp>
+
+namespace xf::sync {
+class LightSemaphore;
+}
+
+namespace xf::sync::isr {
+
+/// An ISR-safe version of `LightSemaphore`, obtained by calling `LightSemaphore::for_isr()`.
+class LightSemaphore {
+public:
+    /// Constructs a new ISR-safe view of the given semaphore.
+    explicit LightSemaphore(sync::LightSemaphore&);
+
+    /// Tries taking a permit and returns whether it was successful.
+    [[nodiscard]] bool try_take();
+
+    /// Gives a permit back and returns whether a context switch needs to be performed.
+    /// Analogous to [`xSemaphoreGiveFromISR`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/10-Semaphore-and-Mutexes/16-xSemaphoreGiveFromISR).
+    [[nodiscard]] xf::isr::HigherPriorityTaskWoken give();
+
+private:
+    sync::LightSemaphore& m_semaphore;
+};
+
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+namespace xf::system {
+
+/// The core id used by `Task` entries that are not pinned to any particular core.
+constexpr BaseType_t ANY_CORE = -1;
+
+/// Describes a queue owned by a `System`.
+/// `Q` is the queue type itself, which must be statically allocated (i.e: a `StaticQueue` instantiation).
+/// The optional `Tag` disambiguates two queues that share the same type.
+template<typename Q, typename Tag = void>
+struct Queue {
+    using Type = Q;
+};
+
+/// Lists the `Queue` entries a task is constructed with, in the order that they appear in the task's constructor.
+template<typename... Queues>
+struct Connect { };
+
+/// Describes a task owned by a `System`.
+/// `T` is the task type, which must be statically allocated (i.e: derive from `StaticTask`), and is constructed with a reference to the queue of each entry in `Connections`.
+/// If `T` declares a `static constexpr const char* NAME` member it is used as the name of the task.
+template<typename T, UBaseType_t PRIORITY, typename QueueConnections = Connect<>, BaseType_t CORE = ANY_CORE>
+struct Task {
+    static_assert(PRIORITY < configMAX_PRIORITIES, "Task priority must be lower than `configMAX_PRIORITIES`");
+
+    using Type = T;
+    using Connections = QueueConnections;
+    static constexpr UBaseType_t TASK_PRIORITY = PRIORITY;
+    static constexpr BaseType_t CORE_ID = CORE;
+};
+
+/// The list of `Queue` entries of a `System`.
+template<typename... Entries>
+struct Queues { };
+
+/// The list of `Task` entries of a `System`.
+template<typename... Entries>
+struct Tasks { };
+
+/// A compile-time description of every task and queue in the firmware, together with the storage for all of them.
+/// Queues are always constructed before tasks, which means tasks can receive references to any queue of the system - including ones consumed by tasks declared later - without the circular dependencies that arise from tasks owning their own queues.
+/// The amount of RAM used by the objects is known at compile time through `RAM`, and is statically asserted to fit in `RAM_BUDGET`.
+/// Declare the system as a `static` (or global) object to have the entire firmware reside in a single contiguous block of memory, then call `create()` once to bring everything up.
+template<typename Queues, typename Tasks, size_t RAM_BUDGET = SIZE_MAX>
+class System;
+
+template<typename... QueueEntries, typename... TaskEntries, size_t RAM_BUDGET>
+class System<Queues<QueueEntries...>, Tasks<TaskEntries...>, RAM_BUDGET> {
+public:
+    /// The amount of memory required by every queue and task of the system, including their stacks and storage buffers.
+    static constexpr size_t RAM = (0 + ... + sizeof(typename QueueEntries::Type)) + (0 + ... + sizeof(typename TaskEntries::Type));
+
+    static_assert(RAM <= RAM_BUDGET, "The system doesn't fit in the given RAM budget");
+
+    /// Constructs every queue, then every task.
+    /// Nothing is valid until `create()` is called.
+    System();
+
+    // The tasks hold references to the queues, so the system must stay in place.
+    System(System&&) = delete;
+    System& operator=(System&&) = delete;
+    System(const System&) = delete;
+    System& operator=(const System&) = delete;
+
+    /// Creates every queue and then every task, in declaration order, and only then lets the tasks start.
+    /// Every task is created with `Task::defer_start()` and held back before its `setup()` until the whole system is created, so tasks never observe a partially initialized system - even when running on another core, which suspending the scheduler wouldn't prevent on SMP ports.
+    void create();
+
+    /// Obtains the queue or task described by the given entry.
+    template<typename Entry>
+    [[nodiscard]] auto& get();
+
+private:
+    template<typename Entry>
+    struct QueueSlot {
+        typename Entry::Type object;
+    };
+
+    template<typename Entry>
+    struct TaskSlot {
+        explicit TaskSlot(std::tuple<QueueSlot<QueueEntries>...>& queues)
+            : TaskSlot(queues, typename Entry::Connections {}) { }
+
+        template<typename... Connections>
+        TaskSlot(std::tuple<QueueSlot<QueueEntries>...>& queues, Connect<Connections...>)
+            : object(std::get<QueueSlot<Connections>>(queues).object...) { }
+
+        void create() {
+            object.defer_start();
+
+            const char* name = nullptr;
+            if constexpr (requires { Entry::Type::NAME; })
+                name = Entry::Type::NAME;
+
+            if constexpr (Entry::CORE_ID == ANY_CORE) {
+                object.create(name, Entry::TASK_PRIORITY);
+            } else {
+#if ESP_PLATFORM
+                object.create_pinned_to_core(name, Entry::TASK_PRIORITY, Entry::CORE_ID);
+#else
+                static_assert(Entry::CORE_ID == ANY_CORE, "Pinning tasks to a core is only supported on ESP-IDF");
+#endif
+            }
+        }
+
+        typename Entry::Type object;
+    };
+
+    // Used to repeat the queue tuple once for each task when constructing `m_tasks`.
+    template<typename>
+    std::tuple<QueueSlot<QueueEntries>...>& queues() { return m_queues; }
+
+    std::tuple<QueueSlot<QueueEntries>...> m_queues;
+    std::tuple<TaskSlot<TaskEntries>...> m_tasks;
+};
+
+template<typename... QueueEntries, typename... TaskEntries, size_t RAM_BUDGET>
+System<Queues<QueueEntries...>, Tasks<TaskEntries...>, RAM_BUDGET>::System()
+    : m_tasks(queues<TaskEntries>()...) {
+}
+
+template<typename... QueueEntries, typename... TaskEntries, size_t RAM_BUDGET>
+void System<Queues<QueueEntries...>, Tasks<TaskEntries...>, RAM_BUDGET>::create() {
+    std::apply([](auto&... slots) { (slots.object.create(), ...); }, m_queues);
+    std::apply([](auto&... slots) { (slots.create(), ...); }, m_tasks);
+    std::apply([](auto&... slots) { (slots.object.start(), ...); }, m_tasks);
+}
+
+template<typename... QueueEntries, typename... TaskEntries, size_t RAM_BUDGET>
+template<typename Entry>
+auto& System<Queues<QueueEntries...>, Tasks<TaskEntries...>, RAM_BUDGET>::get() {
+    if constexpr ((std::is_same_v<Entry, QueueEntries> or ...)) {
+        return std::get<QueueSlot<Entry>>(m_queues).object;
+    } else {
+        static_assert((std::is_same_v<Entry, TaskEntries> or ...), "Entry is not part of this system");
+        return std::get<TaskSlot<Entry>>(m_tasks).object;
+    }
+}
+
+}
@@ -4,6 +4,7 @@ namespace xf::task {
 
 void BinaryNotification::set() {
     (void)xTaskNotifyIndexed(_handle, _index, true, eSetValueWithOverwrite);
+    sync::wait_graph::note_producer(this);
 }
 
 void BinaryNotification::await_get() {
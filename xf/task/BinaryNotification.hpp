@@ -5,6 +5,7 @@
 
 #include "Notification.hpp"
 #include "isr/BinaryNotification.hpp"
+#include <xf/sync/WaitGraph.hpp>
 #include <xf/time/time.hpp>
 
 namespace xf::task {
@@ -32,6 +33,7 @@ struct BinaryNotification : Notification {
 
 template<typename Rep, typename Period>
 [[nodiscard]] bool BinaryNotification::get(std::chrono::duration<Rep, Period> timeout) {
+    sync::wait_graph::Blocked blocked { sync::wait_graph::Kind::Notification, this };
     return static_cast<bool>(xTaskNotifyWaitIndexed(_index, 0, UINT32_MAX, nullptr, time::to_raw_tick(timeout)));
 }
 
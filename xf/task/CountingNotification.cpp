@@ -4,10 +4,19 @@ namespace xf::task {
 
 void CountingNotification::give() {
     (void)xTaskNotifyGiveIndexed(_handle, _index);
+    sync::wait_graph::note_producer(this);
+}
+
+[[nodiscard]] uint32_t CountingNotification::await_take_one() {
+    return take_one(time::FOREVER).value();
+}
+
+[[nodiscard]] uint32_t CountingNotification::await_take_all() {
+    return take_all(time::FOREVER).value();
 }
 
 [[nodiscard]] uint32_t CountingNotification::await_take() {
-    return take(time::FOREVER).value();
+    return await_take_all();
 }
 
 [[nodiscard]] uint32_t CountingNotification::await_fetch() {
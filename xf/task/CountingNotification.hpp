@@ -1,10 +1,14 @@
 #pragma once
 
 #include <chrono>
+#include <functional>
 #include <optional>
+#include <utility>
 
 #include "Notification.hpp"
 #include "isr/CountingNotification.hpp"
+#include <xf/fn.hpp>
+#include <xf/sync/WaitGraph.hpp>
 #include <xf/time/time.hpp>
 
 namespace xf::task {
@@ -16,16 +20,47 @@ struct CountingNotification : Notification {
     /// Analogous to [`xTaskNotifyGive`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/05-Direct-to-task-notifications/01-xTaskNotifyGive).
     void give();
 
-    /// Waits indefinitely for the notification to be pending then decrements the counter, returning the previous value.
-    /// Analogous to [`ulTaskNotifyTake`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/05-Direct-to-task-notifications/03-ulTaskNotifyTake).
-    [[nodiscard]] uint32_t await_take();
+    /// Waits indefinitely for the notification to be pending then decrements the counter by one, returning the value it had before being decremented.
+    /// Use this to process pending events one at a time.
+    /// Analogous to [`ulTaskNotifyTake`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/05-Direct-to-task-notifications/03-ulTaskNotifyTake) with `xClearCountOnExit` set to `pdFALSE`.
+    [[nodiscard]] uint32_t await_take_one();
 
-    /// Waits up to `timeout` amount of time for the notification to be pending then decrements the counter and obtains the previous value, otherwise returns `std::nullopt`.
+    /// Waits up to `timeout` amount of time for the notification to be pending then decrements the counter by one and obtains the value it had before being decremented, otherwise returns `std::nullopt`.
     /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
-    /// Analogous to  [`ulTaskNotifyTake`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/05-Direct-to-task-notifications/03-ulTaskNotifyTake).
+    /// Analogous to [`ulTaskNotifyTake`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/05-Direct-to-task-notifications/03-ulTaskNotifyTake) with `xClearCountOnExit` set to `pdFALSE`.
+    template<typename Rep, typename Period>
+    [[nodiscard]] std::optional<uint32_t> take_one(std::chrono::duration<Rep, Period> timeout);
+
+    /// Waits indefinitely for the notification to be pending then resets the counter to 0, returning the number of events that were pending.
+    /// Use this to process every pending event in a single wake-up.
+    /// Analogous to [`ulTaskNotifyTake`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/05-Direct-to-task-notifications/03-ulTaskNotifyTake) with `xClearCountOnExit` set to `pdTRUE`.
+    [[nodiscard]] uint32_t await_take_all();
+
+    /// Waits up to `timeout` amount of time for the notification to be pending then resets the counter to 0 and obtains the number of events that were pending, otherwise returns `std::nullopt`.
+    /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
+    /// Analogous to [`ulTaskNotifyTake`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/05-Direct-to-task-notifications/03-ulTaskNotifyTake) with `xClearCountOnExit` set to `pdTRUE`.
+    template<typename Rep, typename Period>
+    [[nodiscard]] std::optional<uint32_t> take_all(std::chrono::duration<Rep, Period> timeout);
+
+    /// Waits indefinitely for the notification to be pending then resets the counter to 0, returning the number of events that were pending.
+    /// Equivalent to `await_take_all()`.
+    [[nodiscard]] uint32_t await_take();
+
+    /// Waits up to `timeout` amount of time for the notification to be pending then resets the counter to 0 and obtains the number of events that were pending, otherwise returns `std::nullopt`.
+    /// Equivalent to `take_all()`.
     template<typename Rep, typename Period>
     [[nodiscard]] std::optional<uint32_t> take(std::chrono::duration<Rep, Period> timeout);
 
+    /// Waits indefinitely for the notification to be pending then drains every pending event and invokes the callback with their amount.
+    /// Lets a consumer process N events per wake-up instead of waking up N times.
+    template<Fn<void(uint32_t)> FN>
+    void await_batch(FN&& callback);
+
+    /// Waits up to `timeout` amount of time for the notification to be pending then drains every pending event and invokes the callback with their amount, returning whether it was invoked.
+    /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
+    template<Fn<void(uint32_t)> FN, typename Rep, typename Period>
+    [[nodiscard]] bool batch(FN&& callback, std::chrono::duration<Rep, Period> timeout);
+
     /// Waits indefinitely for the notification to be pending then obtains the current value without decrementing it.
     [[nodiscard]] uint32_t await_fetch();
 
@@ -48,16 +83,48 @@ struct CountingNotification : Notification {
 };
 
 template<typename Rep, typename Period>
-[[nodiscard]] std::optional<uint32_t> CountingNotification::take(std::chrono::duration<Rep, Period> timeout) {
-    BaseType_t value = ulTaskNotifyTakeIndexed(_index, pdTRUE, time::to_raw_tick(timeout));
-    if (value == pdFALSE)
+[[nodiscard]] std::optional<uint32_t> CountingNotification::take_one(std::chrono::duration<Rep, Period> timeout) {
+    sync::wait_graph::Blocked blocked { sync::wait_graph::Kind::Notification, this };
+    uint32_t value = ulTaskNotifyTakeIndexed(_index, pdFALSE, time::to_raw_tick(timeout));
+    if (value == 0)
+        return std::nullopt;
+
+    return value;
+}
+
+template<typename Rep, typename Period>
+[[nodiscard]] std::optional<uint32_t> CountingNotification::take_all(std::chrono::duration<Rep, Period> timeout) {
+    sync::wait_graph::Blocked blocked { sync::wait_graph::Kind::Notification, this };
+    uint32_t value = ulTaskNotifyTakeIndexed(_index, pdTRUE, time::to_raw_tick(timeout));
+    if (value == 0)
         return std::nullopt;
 
     return value;
 }
 
+template<typename Rep, typename Period>
+[[nodiscard]] std::optional<uint32_t> CountingNotification::take(std::chrono::duration<Rep, Period> timeout) {
+    return take_all(timeout);
+}
+
+template<Fn<void(uint32_t)> FN>
+void CountingNotification::await_batch(FN&& callback) {
+    std::invoke(std::forward<FN>(callback), await_take_all());
+}
+
+template<Fn<void(uint32_t)> FN, typename Rep, typename Period>
+[[nodiscard]] bool CountingNotification::batch(FN&& callback, std::chrono::duration<Rep, Period> timeout) {
+    auto count = take_all(timeout);
+    if (!count)
+        return false;
+
+    std::invoke(std::forward<FN>(callback), *count);
+    return true;
+}
+
 template<typename Rep, typename Period>
 [[nodiscard]] std::optional<uint32_t> CountingNotification::fetch(std::chrono::duration<Rep, Period> timeout) {
+    sync::wait_graph::Blocked blocked { sync::wait_graph::Kind::Notification, this };
     uint32_t result = 0;
 
     BaseType_t received = xTaskNotifyWaitIndexed(_index, 0, 0, &result, time::to_raw_tick(timeout));
@@ -0,0 +1,119 @@
+#include "EventLoop.hpp"
+
+#include <algorithm>
+#include <type_traits>
+
+namespace xf::task {
+
+// Compares ticks in a way that is resilient to the tick count wrapping around.
+static bool is_due(time::Tick due, time::Tick now) {
+    return static_cast<std::make_signed_t<TickType_t>>((now - due).count()) >= 0;
+}
+
+void EventSource::raise() {
+    configASSERT(m_loop);
+    (void)xTaskNotifyIndexed(m_loop->m_task_handle, tskDEFAULT_INDEX_TO_NOTIFY, m_bit, eSetBits);
+}
+
+isr::EventSource EventSource::to_isr() {
+    configASSERT(m_loop and m_loop->m_task_handle);
+    return { m_loop->m_task_handle, m_bit };
+}
+
+const time::Timing& EventSource::timing() const {
+    return m_timing;
+}
+
+void TimedSource::arm_raw(TickType_t delay, TickType_t period) {
+    m_due = time::now() + time::Duration { delay };
+    m_period = period;
+    m_armed = true;
+}
+
+void TimedSource::disarm() {
+    m_armed = false;
+}
+
+bool TimedSource::is_armed() const {
+    return m_armed;
+}
+
+const time::Timing& TimedSource::timing() const {
+    return m_timing;
+}
+
+void EventLoopBase::add(EventSource& source) {
+    configASSERT(source.m_loop == nullptr);
+    configASSERT(m_source_count < MAX_SOURCES);
+
+    source.m_loop = this;
+    source.m_bit = 1u << m_source_count;
+    m_sources[m_source_count++] = &source;
+}
+
+void EventLoopBase::add(TimedSource& source) {
+    source.m_next = std::exchange(m_timed_sources, &source);
+}
+
+const time::Timing& EventLoopBase::iteration_timing() const {
+    return m_iteration_timing;
+}
+
+void EventLoopBase::loop() {
+    while (true) {
+        uint32_t ready = 0;
+        (void)xTaskNotifyWaitIndexed(tskDEFAULT_INDEX_TO_NOTIFY, 0, UINT32_MAX, &ready, ticks_until_next_deadline());
+
+        const auto start = time::CycleClock::now();
+
+        for (size_t i = 0; i < m_source_count; ++i) {
+            if (ready & m_sources[i]->m_bit)
+                dispatch(*m_sources[i]);
+        }
+
+        const auto now = time::now();
+        for (auto* source = m_timed_sources; source; source = source->m_next) {
+            if (not source->m_armed or not is_due(source->m_due, now))
+                continue;
+
+            if (source->m_period == 0) {
+                source->m_armed = false;
+            } else {
+                // Skip the periods that were missed instead of dispatching the source in a burst.
+                source->m_due += time::Duration { source->m_period };
+                if (is_due(source->m_due, now))
+                    source->m_due = now + time::Duration { source->m_period };
+            }
+
+            dispatch(*source);
+        }
+
+        m_iteration_timing.record(time::CycleClock::now() - start);
+    }
+}
+
+template<typename Source>
+void EventLoopBase::dispatch(Source& source) {
+    const auto start = time::CycleClock::now();
+    source.dispatch();
+    source.m_timing.record(time::CycleClock::now() - start);
+}
+
+TickType_t EventLoopBase::ticks_until_next_deadline() const {
+    TickType_t ticks = portMAX_DELAY;
+
+    const auto now = time::now();
+    for (const auto* source = m_timed_sources; source; source = source->m_next) {
+        if (not source->m_armed)
+            continue;
+
+        if (is_due(source->m_due, now))
+            return 0;
+
+        ticks = std::min(ticks, static_cast<TickType_t>((source->m_due - now).count()));
+    }
+
+    return ticks;
+}
+
+}
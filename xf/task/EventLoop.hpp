@@ -0,0 +1,292 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "StaticTask.hpp"
+#include "isr/EventSource.hpp"
+#include <xf/fn.hpp>
+#include <xf/queue/Queue.hpp>
+#include <xf/time/CycleClock.hpp>
+#include <xf/time/time.hpp>
+
+namespace xf::task {
+
+class EventLoopBase;
+
+/// A source of events that wakes up the event loop when raised, such as a `Signal` or a `Receiver`.
+/// Sources are dispatched by the loop's task, one at a time and always to completion, so handlers must never block.
+class EventSource {
+public:
+    // The loop refers to it's sources by address, so they must stay in place.
+    EventSource(EventSource&&) = delete;
+    EventSource& operator=(EventSource&&) = delete;
+    EventSource(const EventSource&) = delete;
+    EventSource& operator=(const EventSource&) = delete;
+
+    /// Marks the source as ready, making the loop dispatch it in it's next iteration.
+    /// Raising a source multiple times before it is dispatched results in a single dispatch.
+    void raise();
+
+    /// Creates an ISR-safe version of the source.
+    /// Only valid after the loop's task has been created.
+    [[nodiscard]] isr::EventSource to_isr();
+
+    /// Obtains how long the handler of this source takes to run.
+    [[nodiscard]] const time::Timing& timing() const;
+
+protected:
+    EventSource() = default;
+    ~EventSource() = default;
+
+private:
+    friend EventLoopBase;
+
+    virtual void dispatch() = 0;
+
+    EventLoopBase* m_loop { nullptr };
+    uint32_t m_bit { 0 };
+    time::Timing m_timing;
+};
+
+/// A source of events that is dispatched when a point in time is reached, such as a `Deadline`.
+class TimedSource {
+public:
+    // The loop refers to it's sources by address, so they must stay in place.
+    TimedSource(TimedSource&&) = delete;
+    TimedSource& operator=(TimedSource&&) = delete;
+    TimedSource(const TimedSource&) = delete;
+    TimedSource& operator=(const TimedSource&) = delete;
+
+    /// Makes the source be dispatched once, after `delay`.
+    /// Must only be called from the loop's task (i.e. from a handler), or before the loop's task is created.
+    /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
+    template<typename Rep, typename Period>
+    void arm(std::chrono::duration<Rep, Period> delay);
+
+    /// Makes the source be dispatched every `period`, starting one `period` from now.
+    /// Must only be called from the loop's task (i.e. from a handler), or before the loop's task is created.
+    /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
+    template<typename Rep, typename Period>
+    void arm_periodic(std::chrono::duration<Rep, Period> period);
+
+    /// Stops the source from being dispatched.
+    /// Must only be called from the loop's task (i.e. from a handler), or before the loop's task is created.
+    void disarm();
+
+    /// Returns whether the source is going to be dispatched.
+    [[nodiscard]] bool is_armed() const;
+
+    /// Obtains how long the handler of this source takes to run.
+    [[nodiscard]] const time::Timing& timing() const;
+
+protected:
+    TimedSource() = default;
+    ~TimedSource() = default;
+
+private:
+    friend EventLoopBase;
+
+    virtual void dispatch() = 0;
+
+    void arm_raw(TickType_t delay, TickType_t period);
+
+    TimedSource* m_next { nullptr };
+    time::Tick m_due {};
+    TickType_t m_period { 0 };
+    bool m_armed { false };
+    time::Timing m_timing;
+};
+
+/// A source that invokes a callback whenever it is raised, usually by an ISR through `to_isr()`.
+template<Fn<void()> FN>
+class Signal : public EventSource {
+public:
+    explicit Signal(FN callback)
+        : m_callback(std::move(callback)) { }
+
+private:
+    void dispatch() override { std::invoke(m_callback); }
+
+    FN m_callback;
+};
+
+/// A source that invokes a callback for each item received from a queue.
+/// Items must be sent through the receiver (or the queue's sender must `raise()` the receiver after sending), which is what wakes up the loop.
+/// At most `batch` items are handled per dispatch, after which the receiver raises itself again to give other sources a chance to run.
+template<typename Item, Fn<void(Item)> FN>
+class Receiver : public EventSource {
+public:
+    Receiver(queue::Queue<Item>& queue, FN callback, size_t batch = 16)
+        : m_queue(queue)
+        , m_callback(std::move(callback))
+        , m_batch(batch) { }
+
+    /// Waits indefinitely for the item to be pushed to the back of the queue and then raises the receiver.
+    void await_send(const Item&);
+
+    /// Waits indefinitely for the item to be pushed to the back of the queue and then raises the receiver.
+    void await_send(Item&&);
+
+    /// Waits up to `timeout` amount of time for the item to be pushed to the back of the queue, raises the receiver if it did so and returns whether it did so.
+    /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
+    template<typename Rep, typename Period>
+    [[nodiscard]] bool send(const Item&, std::chrono::duration<Rep, Period> timeout);
+
+    /// Waits up to `timeout` amount of time for the item to be pushed to the back of the queue, raises the receiver if it did so and returns whether it did so.
+    /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
+    template<typename Rep, typename Period>
+    [[nodiscard]] bool send(Item&&, std::chrono::duration<Rep, Period> timeout);
+
+private:
+    void dispatch() override;
+
+    queue::Queue<Item>& m_queue;
+    FN m_callback;
+    size_t m_batch;
+};
+
+/// A source that invokes a callback when it's deadline is reached. See `TimedSource` for how to arm it.
+template<Fn<void()> FN>
+class Deadline : public TimedSource {
+public:
+    explicit Deadline(FN callback)
+        : m_callback(std::move(callback)) { }
+
+private:
+    void dispatch() override { std::invoke(m_callback); }
+
+    FN m_callback;
+};
+
+/// The task-independent part of `EventLoop`, refer to it's documentation for more information.
+class EventLoopBase {
+public:
+    /// The maximum number of `EventSource`s a loop can have. There is no limit on `TimedSource`s.
+    static constexpr size_t MAX_SOURCES = 32;
+
+    // Sources refer to the loop by address, so it must stay in place.
+    EventLoopBase(EventLoopBase&&) = delete;
+    EventLoopBase& operator=(EventLoopBase&&) = delete;
+    EventLoopBase(const EventLoopBase&) = delete;
+    EventLoopBase& operator=(const EventLoopBase&) = delete;
+
+    /// Registers a source with the loop.
+    /// Must only be called from the loop's task, or before the loop's task is created.
+    void add(EventSource&);
+
+    /// Registers a timed source with the loop.
+    /// Must only be called from the loop's task, or before the loop's task is created.
+    void add(TimedSource&);
+
+    /// Obtains how long each iteration of the loop (i.e: dispatching every ready source) takes to run.
+    [[nodiscard]] const time::Timing& iteration_timing() const;
+
+protected:
+    explicit EventLoopBase(const TaskHandle_t& task_handle)
+        : m_task_handle(task_handle) { }
+
+    ~EventLoopBase() = default;
+
+    /// Waits for sources to become ready and dispatches them, forever.
+    void loop();
+
+private:
+    friend EventSource;
+
+    template<typename Source>
+    static void dispatch(Source&);
+
+    TickType_t ticks_until_next_deadline() const;
+
+    const TaskHandle_t& m_task_handle;
+
+    std::array<EventSource*, MAX_SOURCES> m_sources {};
+    size_t m_source_count { 0 };
+
+    TimedSource* m_timed_sources { nullptr };
+
+    time::Timing m_iteration_timing;
+};
+
+/// A task that multiplexes any number of event sources - signals raised by ISRs, queues and deadlines - dispatching their handlers in a run-to-completion loop.
+/// This allows many drivers to share a single task and stack, registering handlers instead of owning a task each.
+/// The loop sleeps until a source is raised or a deadline is reached, then dispatches every ready source in a single batch. Each iteration and each handler is timed using the `CycleClock`, see `iteration_timing()` and `EventSource::timing()`.
+/// The loop uses the task's default notification (`tskDEFAULT_INDEX_TO_NOTIFY`) to be woken up, with one bit per `EventSource`.
+template<size_t STACK_DEPTH>
+class EventLoop : public StaticTask<STACK_DEPTH>,
+                  public EventLoopBase {
+public:
+    /// Constructs a new event loop without any sources.
+    /// The loop is not yet valid and must be made so by calling the `create()` function before being used.
+    EventLoop()
+        : EventLoopBase(this->m_handle) { }
+
+private:
+    void run() override { loop(); }
+};
+
+template<typename Rep, typename Period>
+void TimedSource::arm(std::chrono::duration<Rep, Period> delay) {
+    arm_raw(time::to_raw_tick(delay), 0);
+}
+
+template<typename Rep, typename Period>
+void TimedSource::arm_periodic(std::chrono::duration<Rep, Period> period) {
+    const auto ticks = time::to_raw_tick(period);
+    arm_raw(ticks, ticks);
+}
+
+template<typename Item, Fn<void(Item)> FN>
+void Receiver<Item, FN>::await_send(const Item& item) {
+    (void)send(item, time::FOREVER);
+}
+
+template<typename Item, Fn<void(Item)> FN>
+void Receiver<Item, FN>::await_send(Item&& item) {
+    (void)send(std::move(item), time::FOREVER);
+}
+
+template<typename Item, Fn<void(Item)> FN>
+template<typename Rep, typename Period>
+bool Receiver<Item, FN>::send(const Item& item, std::chrono::duration<Rep, Period> timeout) {
+    if (not m_queue.send(item, timeout))
+        return false;
+
+    raise();
+    return true;
+}
+
+template<typename Item, Fn<void(Item)> FN>
+template<typename Rep, typename Period>
+bool Receiver<Item, FN>::send(Item&& item, std::chrono::duration<Rep, Period> timeout) {
+    if (not m_queue.send(std::move(item), timeout))
+        return false;
+
+    raise();
+    return true;
+}
+
+template<typename Item, Fn<void(Item)> FN>
+void Receiver<Item, FN>::dispatch() {
+    for (size_t i = 0; i < m_batch; ++i) {
+        auto item = m_queue.receive(time::NO_WAIT);
+        if (not item)
+            return;
+
+        std::invoke(m_callback, std::move(*item));
+    }
+
+    // Out of budget, come back in the next iteration.
+    if (not m_queue.is_empty())
+        raise();
+}
+
+}
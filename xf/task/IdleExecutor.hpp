@@ -0,0 +1,144 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+
+#include <xf/StaticVector.hpp>
+#include <xf/fn.hpp>
+#include <xf/sync/CriticalSection.hpp>
+#include <xf/time/CycleClock.hpp>
+
+namespace xf::task {
+
+/// Runs background jobs (e.g: flash wear levelling, statistics compaction, checksum verification) only when the CPU would otherwise be idle, without preempting the idle task's power saving the way even a priority-1 task would.
+/// Jobs are resumable: each call to a job performs one short step of its work and returns `ControlFlow::Continue` if there is more to do, or `ControlFlow::Break` once it is done, at which point it is removed from the executor.
+/// The executor is advanced in bounded slices through `run_slice()`, meant to be called from the idle hook, e.g:
+/// ```cpp
+/// static xf::task::IdleExecutor<4> executor;
+/// extern "C" void vApplicationIdleHook() { (void)executor.run_slice(200us); }
+/// // Or, on ESP-IDF, letting the idle task sleep once there's nothing left to do:
+/// esp_register_freertos_idle_hook_for_cpu([] { return !executor.run_slice(200us); }, 0);
+/// ```
+/// Up to `CAPACITY` jobs can be pending at a time, and jobs can be submitted from any task. Steps run in the context of the idle task, so they must never block.
+template<size_t CAPACITY>
+class IdleExecutor {
+public:
+    /// Statistics of the work performed by the executor.
+    struct Stats {
+        /// How many slices have been run.
+        uint32_t slices { 0 };
+        /// How many job steps have been run.
+        uint32_t steps { 0 };
+        /// How many jobs have finished.
+        uint32_t completed { 0 };
+        /// The total time spent running jobs, which is idle CPU time put to use.
+        std::chrono::microseconds reclaimed { 0 };
+    };
+
+    /// Adds a job to the executor and returns whether there was room for it.
+    /// The job is called as `job()` and is referenced by the executor, so it must outlive its execution.
+    template<Fn<ControlFlow()> FN>
+    [[nodiscard]] bool submit(FN& job);
+
+    /// Adds a job to the executor, called as `step(context)`, and returns whether there was room for it.
+    [[nodiscard]] bool submit(ControlFlow (*step)(void*), void* context);
+
+    /// Runs job steps, round-robin, until either `budget` amount of time has passed or there are no jobs left, and returns whether there are jobs left.
+    /// The budget is only checked between steps, so a step that runs for longer than the budget overruns it. At least one step is run if there are jobs pending.
+    /// Must only be called from a single context at a time, usually the idle hook.
+    template<typename Rep, typename Period>
+    [[nodiscard]] bool run_slice(std::chrono::duration<Rep, Period> budget);
+
+    /// Obtains the number of jobs pending.
+    [[nodiscard]] size_t pending() const;
+
+    /// Obtains the statistics of the work performed so far.
+    [[nodiscard]] Stats stats() const;
+
+private:
+    struct Job {
+        ControlFlow (*step)(void*);
+        void* context;
+    };
+
+    mutable sync::CriticalSection m_lock;
+    StaticVector<Job, CAPACITY> m_jobs;
+    size_t m_cursor { 0 };
+    Stats m_stats;
+};
+
+template<size_t CAPACITY>
+template<Fn<ControlFlow()> FN>
+bool IdleExecutor<CAPACITY>::submit(FN& job) {
+    return submit([](void* raw_job) { return std::invoke(*static_cast<FN*>(raw_job)); }, &job);
+}
+
+template<size_t CAPACITY>
+bool IdleExecutor<CAPACITY>::submit(ControlFlow (*step)(void*), void* context) {
+    return m_lock.locked([&] { return m_jobs.push_back(Job { step, context }); });
+}
+
+template<size_t CAPACITY>
+template<typename Rep, typename Period>
+bool IdleExecutor<CAPACITY>::run_slice(std::chrono::duration<Rep, Period> budget) {
+    const auto start = time::CycleClock::now();
+    auto elapsed = time::CycleClock::duration::zero();
+
+    uint32_t steps = 0;
+    uint32_t completed = 0;
+    bool jobs_left = true;
+
+    do {
+        // Only this function removes jobs, so the index stays valid while the job runs even if new ones are submitted in the meantime
+        std::optional<Job> job = m_lock.locked([&]() -> std::optional<Job> {
+            if (m_jobs.empty())
+                return std::nullopt;
+            if (m_cursor >= m_jobs.size())
+                m_cursor = 0;
+            return m_jobs[m_cursor];
+        });
+        if (!job) {
+            jobs_left = false;
+            break;
+        }
+
+        ++steps;
+        if (job->step(job->context) == ControlFlow::Break) {
+            ++completed;
+            jobs_left = m_lock.locked([&] {
+                m_jobs.erase(m_cursor);
+                return !m_jobs.empty();
+            });
+        } else {
+            ++m_cursor;
+        }
+
+        elapsed = time::CycleClock::now() - start;
+    } while (jobs_left && elapsed < budget);
+
+    if (steps > 0) {
+        m_lock.locked([&] {
+            ++m_stats.slices;
+            m_stats.steps += steps;
+            m_stats.completed += completed;
+            m_stats.reclaimed += std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
+        });
+    }
+
+    return jobs_left;
+}
+
+template<size_t CAPACITY>
+size_t IdleExecutor<CAPACITY>::pending() const {
+    return m_lock.locked([&] { return m_jobs.size(); });
+}
+
+template<size_t CAPACITY>
+typename IdleExecutor<CAPACITY>::Stats IdleExecutor<CAPACITY>::stats() const {
+    return m_lock.locked([&] { return m_stats; });
+}
+
+}
@@ -0,0 +1,108 @@
+#include "SharedStack.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include "StaticTask.hpp"
+
+namespace xf::task {
+
+static_assert(XF_SYNC_NOTIFICATION_INDEX != tskDEFAULT_INDEX_TO_NOTIFY, "`XF_SYNC_NOTIFICATION_INDEX` must not be the default notification index, raise `configTASK_NOTIFICATION_ARRAY_ENTRIES` to at least 2");
+
+namespace {
+
+class SharedStackTask final : public StaticTask<XF_SHARED_STACK_DEPTH> {
+public:
+    SharedStackTask() {
+        m_lock = xSemaphoreCreateMutexStatic(&m_static_lock);
+        m_priority_lock = xSemaphoreCreateMutexStatic(&m_static_priority_lock);
+        create("xf shared stack", tskIDLE_PRIORITY);
+    }
+
+    void execute(void (*job)(void*), void* context) {
+        const UBaseType_t priority = uxTaskPriorityGet(nullptr);
+
+        // Only the caller holding the lock inherits the priority of the ones queued behind it, so they raise the task themselves.
+        adjust_priority([&] { ++m_waiting[priority]; });
+        (void)xSemaphoreTake(m_lock, portMAX_DELAY);
+        adjust_priority([&] {
+            --m_waiting[priority];
+            m_holder_priority = priority;
+        });
+
+        m_job = job;
+        m_context = context;
+        m_caller = xTaskGetCurrentTaskHandle();
+        m_done.store(false, std::memory_order_relaxed);
+
+        (void)xTaskNotifyStateClearIndexed(nullptr, XF_SYNC_NOTIFICATION_INDEX);
+        (void)ulTaskNotifyValueClearIndexed(nullptr, XF_SYNC_NOTIFICATION_INDEX, UINT32_MAX);
+        (void)xTaskNotifyGiveIndexed(m_handle, XF_SYNC_NOTIFICATION_INDEX);
+
+        // The job lives on this task's stack, so returning before it's done - because of a stray notification - must never happen.
+        while (not m_done.load(std::memory_order_acquire))
+            (void)ulTaskNotifyTakeIndexed(XF_SYNC_NOTIFICATION_INDEX, pdTRUE, portMAX_DELAY);
+
+        (void)xSemaphoreGive(m_lock);
+    }
+
+private:
+    void run() override {
+        while (true) {
+            (void)ulTaskNotifyTakeIndexed(XF_SYNC_NOTIFICATION_INDEX, pdTRUE, portMAX_DELAY);
+
+            m_job(m_context);
+
+            // The caller may return as soon as it sees the job done, so it's handle is read beforehand.
+            auto* caller = m_caller;
+            m_done.store(true, std::memory_order_release);
+            (void)xTaskNotifyGiveIndexed(caller, XF_SYNC_NOTIFICATION_INDEX);
+        }
+    }
+
+    // Runs the job at the highest priority among the caller holding the lock and the callers waiting for it, which are all blocked until it's done anyway.
+    template<typename FN>
+    void adjust_priority(FN&& update) {
+        (void)xSemaphoreTake(m_priority_lock, portMAX_DELAY);
+
+        update();
+
+        UBaseType_t priority = m_holder_priority;
+        for (UBaseType_t p = priority + 1; p < configMAX_PRIORITIES; ++p) {
+            if (m_waiting[p] > 0)
+                priority = p;
+        }
+        vTaskPrioritySet(m_handle, priority);
+
+        (void)xSemaphoreGive(m_priority_lock);
+    }
+
+    SemaphoreHandle_t m_lock;
+    StaticSemaphore_t m_static_lock;
+
+    SemaphoreHandle_t m_priority_lock;
+    StaticSemaphore_t m_static_priority_lock;
+    UBaseType_t m_holder_priority { tskIDLE_PRIORITY };
+    // How many callers of each priority are waiting for `m_lock`.
+    std::array<uint16_t, configMAX_PRIORITIES> m_waiting {};
+
+    void (*m_job)(void*) { nullptr };
+    void* m_context { nullptr };
+    TaskHandle_t m_caller { nullptr };
+    std::atomic<bool> m_done { false };
+};
+
+}
+
+void detail::run_on_shared_stack(void (*job)(void*), void* context) {
+    // Constructed on first use, so the helper task only exists once something needs it
+    static SharedStackTask task;
+    task.execute(job, context);
+}
+
+}
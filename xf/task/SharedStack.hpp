@@ -0,0 +1,54 @@
+#pragma once
+
+#include <concepts>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include <xf/config.hpp>
+
+namespace xf::task {
+
+/// Invokes the given callback on a single large stack shared by the whole firmware, blocking the calling task until it returns, and returns the return value of the callback.
+/// Meant for rare operations that need a lot of stack (e.g: a TLS handshake or parsing a large JSON document), so that tasks which only occasionally run them can be sized for their regular workload instead.
+/// The stack belongs to a helper task, sized by `XF_SHARED_STACK_DEPTH` and created on the first call, which runs one callback at a time. Concurrent callers are serialized by a mutex, and the callback runs at the highest priority among the task that requested it and the tasks waiting for their turn, so a queued caller is never held back by a lower priority callback.
+/// Since the callback runs in the context of another task, it must not rely on the identity of the calling task - e.g: by waiting on its notifications or using its thread-local storage.
+/// The calling task is blocked through the `XF_SYNC_NOTIFICATION_INDEX` notification, see its documentation for the restrictions that implies.
+template<std::invocable FN, typename R = std::invoke_result_t<FN>>
+R run_on_shared_stack(FN&& callback);
+
+namespace detail {
+
+void run_on_shared_stack(void (*job)(void*), void* context);
+
+}
+
+template<std::invocable FN, typename R>
+R run_on_shared_stack(FN&& callback) {
+    if constexpr (std::is_void_v<R>) {
+        struct Job {
+            FN&& callback;
+        } job { std::forward<FN>(callback) };
+
+        detail::run_on_shared_stack([](void* raw_job) {
+            std::invoke(std::forward<FN>(static_cast<Job*>(raw_job)->callback));
+        },
+            &job);
+    } else {
+        struct Job {
+            FN&& callback;
+            std::optional<R> result;
+        } job { std::forward<FN>(callback), std::nullopt };
+
+        detail::run_on_shared_stack([](void* raw_job) {
+            auto& job = *static_cast<Job*>(raw_job);
+            job.result.emplace(std::invoke(std::forward<FN>(job.callback)));
+        },
+            &job);
+
+        return std::move(*job.result);
+    }
+}
+
+}
@@ -6,6 +6,7 @@
 
 #include "Notification.hpp"
 #include "isr/StateNotification.hpp"
+#include <xf/sync/WaitGraph.hpp>
 #include <xf/time/time.hpp>
 
 namespace xf::task {
@@ -38,6 +39,7 @@ void StateNotification<T>::set(T state) {
     uint32_t raw_value = 0;
     std::memcpy(&raw_value, &state, sizeof(T));
     xTaskNotifyIndexed(_handle, _index, raw_value, eSetValueWithOverwrite);
+    sync::wait_graph::note_producer(this);
 }
 
 template<typename T>
@@ -48,6 +50,7 @@ template<typename T>
 template<typename T>
 template<typename Rep, typename Period>
 [[nodiscard]] std::optional<T> StateNotification<T>::get(std::chrono::duration<Rep, Period> timeout) {
+    sync::wait_graph::Blocked blocked { sync::wait_graph::Kind::Notification, this };
     uint32_t raw_value = 0;
     const auto received = xTaskNotifyWaitIndexed(_index, 0, UINT32_MAX, &raw_value, time::to_raw_tick(timeout));
     if (received == pdFALSE)
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include "TaskBase.hpp"
+
+namespace xf::task {
+
+/// Restricts a template parameter to a callable that can be run by a `StaticFnTask`, which is either invoked without any arguments or with a reference to the task running it.
+template<typename FN, typename... Notifications>
+concept TaskFn = Fn<FN, void()> || Fn<FN, void(TaskBase<Notifications...>&)>;
+
+/// A statically allocated task that runs a callable, such as a lambda, instead of a virtual `run()` method.
+/// The callable is stored inline next to the stack, and there's no vtable nor virtual dispatch involved, making small workers both cheaper and simpler to declare than deriving from `StaticTask`.
+/// The callable is invoked once the task is created, either without arguments or with a reference to the task itself to access the task control API and the notifications, and the task destroys itself when it returns.
+/// The task's stack depth is set and underlying stack memory is allocated based on the `STACK_DEPTH` template parameter.
+/// See `spawn()` for a convenient way of declaring and creating these tasks in one go.
+template<size_t STACK_DEPTH, typename FN, std::derived_from<Notification>... Notifications>
+requires TaskFn<FN, Notifications...>
+class StaticFnTask : public TaskBase<Notifications...> {
+public:
+    static_assert(STACK_DEPTH * sizeof(StackType_t) >= configMINIMAL_STACK_SIZE);
+
+    /// Constructs a new task that will run the given callable.
+    /// The task is not yet valid and must be made so by calling the `create()` function before being used.
+    explicit StaticFnTask(FN);
+
+    /// Create the task and add it to the list of tasks that are ready to run.
+    /// A task must only be created once: after it returns, it's memory stays in use by the kernel until the idle task cleans it up.
+    /// Analogous to [`xTaskCreateStatic`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/01-Task-creation/02-xTaskCreateStatic).
+    void create(const char* name, UBaseType_t priority);
+
+    /// Create the task without using a name and add it to the list of tasks that are ready to run.
+    /// Analogous to  [`xTaskCreateStatic`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/01-Task-creation/02-xTaskCreateStatic).
+    void create(UBaseType_t priority);
+
+#if ESP_PLATFORM
+
+    /// Create the task and pin it to a particular core.
+    /// Analogous to  [`xTaskCreateStaticPinnedToCore`](https://docs.espressif.com/projects/esp-idf/en/release-v5.4/esp32/api-reference/system/freertos_additions.html#_CPPv429xTaskCreateStaticPinnedToCore14TaskFunction_tPCKcK8uint32_tPCv11UBaseType_tPC11StackType_tPC12StaticTask_tK10BaseType_t).
+    void create_pinned_to_core(const char* name, UBaseType_t priority, BaseType_t core_id);
+
+    /// Create the task without using a name and pin it to a particular core.
+    /// Analogous to  [`xTaskCreateStaticPinnedToCore`](https://docs.espressif.com/projects/esp-idf/en/release-v5.4/esp32/api-reference/system/freertos_additions.html#_CPPv429xTaskCreateStaticPinnedToCore14TaskFunction_tPCKcK8uint32_tPCv11UBaseType_tPC11StackType_tPC12StaticTask_tK10BaseType_t).
+    void create_pinned_to_core(UBaseType_t priority, BaseType_t core_id);
+
+#endif
+
+private:
+    /// The raw FreeRTOS task.
+    /// Calls, in order: the callable -> `destroy()`.
+    static void task(void* raw_self);
+
+    FN m_fn;
+
+    StaticTask_t m_task_buffer;
+    std::array<StackType_t, STACK_DEPTH> m_stack_buffer;
+};
+
+/// Declares a `StaticFnTask` running the given callable in static storage and creates it, returning a reference to the task.
+/// The task is keyed on the type of the callable, so the callable must be a lambda or another class type - never a function pointer, which every function of the same signature shares.
+/// Every lambda expression has its own type and therefore its own task, so each one can only be spawned once: spawning the same lambda again (e.g: in a loop or through a helper function) is an error, and is asserted.
+/// Example:
+/// ```cpp
+/// xf::task::spawn<2048>("Blinky", 5, [](auto& self) {
+///     self.every(500ms, [] { toggle_led(); });
+/// });
+/// ```
+template<size_t STACK_DEPTH, std::derived_from<Notification>... Notifications, typename FN>
+requires TaskFn<std::decay_t<FN>, Notifications...>
+StaticFnTask<STACK_DEPTH, std::decay_t<FN>, Notifications...>& spawn(const char* name, UBaseType_t priority, FN&& fn);
+
+template<size_t STACK_DEPTH, typename FN, std::derived_from<Notification>... Notifications>
+requires TaskFn<FN, Notifications...>
+StaticFnTask<STACK_DEPTH, FN, Notifications...>::StaticFnTask(FN fn)
+    : m_fn(std::move(fn)) {
+}
+
+template<size_t STACK_DEPTH, typename FN, std::derived_from<Notification>... Notifications>
+requires TaskFn<FN, Notifications...>
+void StaticFnTask<STACK_DEPTH, FN, Notifications...>::create(const char* name, UBaseType_t priority) {
+    configASSERT(this->m_handle == nullptr);
+    this->m_handle = xTaskCreateStatic(task, name, STACK_DEPTH, this, priority, m_stack_buffer.data(), &m_task_buffer);
+}
+
+template<size_t STACK_DEPTH, typename FN, std::derived_from<Notification>... Notifications>
+requires TaskFn<FN, Notifications...>
+void StaticFnTask<STACK_DEPTH, FN, Notifications...>::create(UBaseType_t priority) {
+    create(nullptr, priority);
+}
+
+#if ESP_PLATFORM
+
+template<size_t STACK_DEPTH, typename FN, std::derived_from<Notification>... Notifications>
+requires TaskFn<FN, Notifications...>
+void StaticFnTask<STACK_DEPTH, FN, Notifications...>::create_pinned_to_core(const char* name, UBaseType_t priority, BaseType_t core_id) {
+    configASSERT(this->m_handle == nullptr);
+    this->m_handle = xTaskCreateStaticPinnedToCore(task, name, STACK_DEPTH, this, priority, m_stack_buffer.data(), &m_task_buffer, core_id);
+}
+
+template<size_t STACK_DEPTH, typename FN, std::derived_from<Notification>... Notifications>
+requires TaskFn<FN, Notifications...>
+void StaticFnTask<STACK_DEPTH, FN, Notifications...>::create_pinned_to_core(UBaseType_t priority, BaseType_t core_id) {
+    create_pinned_to_core(nullptr, priority, core_id);
+}
+
+#endif
+
+template<size_t STACK_DEPTH, typename FN, std::derived_from<Notification>... Notifications>
+requires TaskFn<FN, Notifications...>
+void StaticFnTask<STACK_DEPTH, FN, Notifications...>::task(void* raw_self) {
+    auto& self = *static_cast<StaticFnTask*>(raw_self);
+
+    if constexpr (Fn<FN, void()>)
+        std::invoke(self.m_fn);
+    else
+        std::invoke(self.m_fn, static_cast<TaskBase<Notifications...>&>(self));
+
+    self.destroy();
+}
+
+template<size_t STACK_DEPTH, std::derived_from<Notification>... Notifications, typename FN>
+requires TaskFn<std::decay_t<FN>, Notifications...>
+StaticFnTask<STACK_DEPTH, std::decay_t<FN>, Notifications...>& spawn(const char* name, UBaseType_t priority, FN&& fn) {
+    static_assert(std::is_class_v<std::decay_t<FN>>, "`spawn()` keys the task on the type of the callable, so it must be a lambda (e.g: `[] { worker(); }`) rather than a function pointer");
+
+    // Even once a previous run has returned, it's task control block and stack stay in use by the kernel until the idle task cleans them up, so they can never be handed out again.
+    static std::atomic<bool> spawned { false };
+    configASSERT(not spawned.exchange(true, std::memory_order_relaxed));
+
+    static StaticFnTask<STACK_DEPTH, std::decay_t<FN>, Notifications...> task { std::forward<FN>(fn) };
+    task.create(name, priority);
+    return task;
+}
+
+}
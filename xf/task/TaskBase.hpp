@@ -0,0 +1,221 @@
+#pragma once
+
+#include <functional>
+#include <tuple>
+#include <utility>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "Notification.hpp"
+#include <xf/fn.hpp>
+#include <xf/time/time.hpp>
+
+namespace xf::task {
+
+using Handle = TaskHandle_t;
+
+/// The non-virtual part of every task, implementing the task control API and the array of task notifications on top of a `TaskHandle_t`.
+/// Creating the underlying FreeRTOS task is left to the derived classes: `Task` (and `StaticTask`) run a virtual `run()` method, while `StaticFnTask` runs a callable stored inline.
+/// The array of task notifications is statically determined by the variadic template parameter of this class and each entry can be retrieved by index or type using the `notification()` accessors.
+template<std::derived_from<Notification>... Notifications>
+class TaskBase {
+public:
+    static_assert(sizeof...(Notifications) <= configTASK_NOTIFICATION_ARRAY_ENTRIES, "The number of notifications for a task must be less than or equal to `configTASK_NOTIFICATION_ARRAY_ENTRIES`");
+
+    TaskBase(TaskBase&&) noexcept;
+    TaskBase& operator=(TaskBase&&) noexcept;
+
+    // There is no mechanism in FreeRTOS to copy a task.
+    TaskBase(const TaskBase&) = delete;
+    TaskBase& operator=(const TaskBase&) = delete;
+
+    /// Remove the task from the RTOS kernels management. It will be removed from all ready, blocked, suspended and event lists.
+    /// This function will be automatically called after the task's function returns.
+    /// Analogous to  [`vTaskDelete`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/01-Task-creation/03-vTaskDelete).
+    void destroy();
+
+    // - Task control
+
+    /// Delay a task for a given duration.
+    /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
+    /// Analogous to  [`vTaskDelay`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/02-Task-control/01-vTaskDelay).
+    template<typename Rep, typename Period>
+    void delay(std::chrono::duration<Rep, Period> duration);
+
+    /// Delay a task until a specified time. This function can be used by periodic tasks to ensure a constant execution frequency.
+    /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
+    /// Analogous to  [`xTaskDelayUntil`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/02-Task-control/03-xTaskDelayUntil).
+    template<typename Rep, typename Period>
+    [[nodiscard]] time::Tick delay_until(time::Tick previous_wake_time, std::chrono::duration<Rep, Period> increment);
+
+    /// Runs the given callback every `period` time.
+    /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
+    template<typename Rep, typename Period>
+    void every(std::chrono::duration<Rep, Period> period, Fn<void()> auto&& callback);
+
+    /// Runs the given callback every `period` time.
+    /// The callback controls the flow of the loop by returning `xf::ControlFlow` values.
+    /// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
+    template<typename Rep, typename Period>
+    void every(std::chrono::duration<Rep, Period> period, Fn<ControlFlow()> auto&& callback);
+
+    /// Obtain the priority of the task.
+    /// Analogous to  [`uxTaskPriorityGet`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/02-Task-control/04-uxTaskPriorityGet).
+    [[nodiscard]] UBaseType_t priority() const;
+
+    /// Set the priority of the task.
+    /// Analogous to  [`vTaskPrioritySet`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/02-Task-control/05-vTaskPrioritySet).
+    void set_priority(UBaseType_t);
+
+    /// Suspend the task. When suspended a task will never get any microcontroller processing time, no matter what its priority.
+    /// Analogous to  [`vTaskSuspend`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/02-Task-control/06-vTaskSuspend).
+    void suspend();
+
+    /// Resumes the task from suspension.
+    /// Analogous to  [`vTaskResume`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/02-Task-control/07-vTaskResume).
+    void resume();
+
+    /// Forces a task to leave the Blocked state, and enter the Ready state, even if the event the task was in the Blocked state to wait for has not occurred, and any specified timeout has not expired.
+    /// Analogous to  [`xTaskAbortDelay`](https://www.freertos.org/Documentation/02-Kernel/04-API-references/02-Task-control/09-xTaskAbortDelay).
+    void abort_delay();
+
+    /// Obtains the notification at the specified index, which defaults to `tskDEFAULT_INDEX_TO_NOTIFY`.
+    /// Notifications are specified through the class's variadic template parameter.
+    template<size_t I = tskDEFAULT_INDEX_TO_NOTIFY>
+    [[nodiscard]] auto& notification();
+
+    /// Obtains the notification of the specified type.
+    /// Notifications are specified through the class's variadic template parameter.
+    template<typename Notification>
+    [[nodiscard]] auto& notification();
+
+    /// Obtains the raw `TaskHandle_t` behind the task.
+    [[nodiscard]] Handle raw_handle() const;
+
+protected:
+    TaskBase(size_t notification_index_do_not_override_default_value = 0);
+
+    /// Destroys the task if it has been created, does nothing otherwise
+    ~TaskBase();
+
+    Handle m_handle { nullptr };
+
+private:
+    std::tuple<Notifications...> m_notifications;
+};
+
+template<std::derived_from<Notification>... Notifications>
+TaskBase<Notifications...>::TaskBase(size_t notification_index)
+    : m_notifications {
+        Notifications { m_handle, notification_index++ }...
+    } { }
+
+template<std::derived_from<Notification>... Notifications>
+TaskBase<Notifications...>::~TaskBase() {
+    if (m_handle)
+        destroy();
+}
+
+template<std::derived_from<Notification>... Notifications>
+TaskBase<Notifications...>::TaskBase(TaskBase&& other) noexcept
+    : m_handle(std::exchange(other.m_handle, nullptr))
+    , m_notifications(std::move(other.m_notifications)) {
+}
+
+template<std::derived_from<Notification>... Notifications>
+TaskBase<Notifications...>& TaskBase<Notifications...>::operator=(TaskBase&& other) noexcept {
+    if (this != &other) {
+        if (m_handle)
+            destroy();
+        m_handle = std::exchange(other.m_handle, nullptr);
+        m_notifications = std::move(other.m_notifications);
+    }
+    return *this;
+}
+
+template<std::derived_from<Notification>... Notifications>
+void TaskBase<Notifications...>::destroy() {
+    configASSERT(m_handle);
+    vTaskDelete(std::exchange(m_handle, nullptr));
+}
+
+template<std::derived_from<Notification>... Notifications>
+template<typename Rep, typename Period>
+void TaskBase<Notifications...>::delay(std::chrono::duration<Rep, Period> duration) {
+    vTaskDelay(time::to_raw_tick(duration));
+}
+
+template<std::derived_from<Notification>... Notifications>
+template<typename Rep, typename Period>
+time::Tick TaskBase<Notifications...>::delay_until(time::Tick previous_wake_time, std::chrono::duration<Rep, Period> increment) {
+    auto raw = previous_wake_time.time_since_epoch().count();
+    vTaskDelayUntil(&raw, time::to_raw_tick(increment));
+    return time::Tick { time::Duration { raw } };
+}
+
+template<std::derived_from<Notification>... Notifications>
+template<typename Rep, typename Period>
+void TaskBase<Notifications...>::every(std::chrono::duration<Rep, Period> period, Fn<void()> auto&& callback) {
+    auto time = time::now();
+    while (true) {
+        time = delay_until(time, period);
+        std::invoke(callback);
+    }
+}
+
+template<std::derived_from<Notification>... Notifications>
+template<typename Rep, typename Period>
+void TaskBase<Notifications...>::every(std::chrono::duration<Rep, Period> period, Fn<ControlFlow()> auto&& callback) {
+    auto time = time::now();
+    while (true) {
+        time = delay_until(time, period);
+        if (std::invoke(callback) == ControlFlow::Break)
+            break;
+    }
+}
+
+template<std::derived_from<Notification>... Notifications>
+UBaseType_t TaskBase<Notifications...>::priority() const {
+    return uxTaskPriorityGet(m_handle);
+}
+
+template<std::derived_from<Notification>... Notifications>
+void TaskBase<Notifications...>::set_priority(UBaseType_t p) {
+    vTaskPrioritySet(m_handle, p);
+}
+
+template<std::derived_from<Notification>... Notifications>
+void TaskBase<Notifications...>::suspend() {
+    vTaskSuspend(m_handle);
+}
+
+template<std::derived_from<Notification>... Notifications>
+void TaskBase<Notifications...>::resume() {
+    vTaskResume(m_handle);
+}
+
+template<std::derived_from<Notification>... Notifications>
+void TaskBase<Notifications...>::abort_delay() {
+    xTaskAbortDelay(m_handle);
+}
+
+template<std::derived_from<Notification>... Notifications>
+template<size_t I>
+auto& TaskBase<Notifications...>::notification() {
+    return std::get<I>(m_notifications);
+}
+
+template<std::derived_from<Notification>... Notifications>
+template<typename Notification>
+auto& TaskBase<Notifications...>::notification() {
+    return std::get<Notification>(m_notifications);
+}
+
+template<std::derived_from<Notification>... Notifications>
+Handle TaskBase<Notifications...>::raw_handle() const {
+    return m_handle;
+}
+
+
+}
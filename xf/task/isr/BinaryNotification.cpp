@@ -1,10 +1,13 @@
 #include "BinaryNotification.hpp"
 
+#include <xf/isr/Probe.hpp>
+
 namespace xf::task::isr {
 
 xf::isr::HigherPriorityTaskWoken BinaryNotification::set() {
     BaseType_t higher_priority_task_woken = pdFALSE;
     xTaskNotifyIndexedFromISR(_handle, _index, true, eSetValueWithOverwrite, &higher_priority_task_woken);
+    xf::isr::Probe::stamp_wake();
     return higher_priority_task_woken;
 }
 
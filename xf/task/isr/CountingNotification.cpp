@@ -1,10 +1,13 @@
 #include "CountingNotification.hpp"
 
+#include <xf/isr/Probe.hpp>
+
 namespace xf::task::isr {
 
 xf::isr::HigherPriorityTaskWoken CountingNotification::give() {
     BaseType_t higher_priority_task_woken = pdFALSE;
     vTaskNotifyGiveIndexedFromISR(_handle, _index, &higher_priority_task_woken);
+    xf::isr::Probe::stamp_wake();
     return higher_priority_task_woken;
 }
 
@@ -0,0 +1,16 @@
+#include "EventSource.hpp"
+
+#include <freertos/task.h>
+
+#include <xf/isr/Probe.hpp>
+
+namespace xf::task::isr {
+
+xf::isr::HigherPriorityTaskWoken EventSource::raise() {
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    xTaskNotifyIndexedFromISR(_handle, tskDEFAULT_INDEX_TO_NOTIFY, _bit, eSetBits, &higher_priority_task_woken);
+    xf::isr::Probe::stamp_wake();
+    return higher_priority_task_woken;
+}
+
+}
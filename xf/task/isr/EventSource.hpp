@@ -0,0 +1,18 @@
+#pragma once
+
+#include <freertos/FreeRTOS.h>
+
+#include <xf/isr/isr.hpp>
+
+namespace xf::task::isr {
+
+/// An ISR-safe version of `EventSource`, obtained by calling `EventSource::to_isr()`.
+struct EventSource {
+    /// Marks the source as ready, making the event loop dispatch it in it's next iteration.
+    xf::isr::HigherPriorityTaskWoken raise();
+
+    TaskHandle_t _handle;
+    uint32_t _bit;
+};
+
+}
@@ -4,6 +4,7 @@
 #include <cstring>
 
 #include "Notification.hpp"
+#include <xf/isr/Probe.hpp>
 #include <xf/isr/isr.hpp>
 
 namespace xf::task::isr {
@@ -25,6 +26,7 @@ xf::isr::HigherPriorityTaskWoken StateNotification<T>::set(T state) {
 
     BaseType_t higher_priority_task_woken = pdFALSE;
     xTaskNotifyIndexedFromISR(_handle, _index, raw_value, eSetValueWithOverwrite, &higher_priority_task_woken);
+    xf::isr::Probe::stamp_wake();
     return higher_priority_task_woken;
 }
 
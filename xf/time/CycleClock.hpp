@@ -0,0 +1,66 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#if ESP_PLATFORM
+#    include <esp_cpu.h>
+#    include <sdkconfig.h>
+#endif
+
+namespace xf::time {
+
+/// A high resolution `std::chrono`-compatible clock meant for measuring short intervals, such as how long a piece of code takes to run.
+/// On ESP-IDF it counts CPU cycles, elsewhere it falls back to the FreeRTOS tick count.
+/// The counter is 32 bits wide and wraps around (every ~17 seconds at 240MHz), so time points are only meaningful when subtracted from each other and only for intervals shorter than that. On multi-core chips each core has it's own counter, so both ends of an interval should be measured on the same core.
+/// Safe to use from ISRs.
+struct CycleClock {
+#if ESP_PLATFORM
+    using rep = uint32_t;
+    using period = std::ratio<1, CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ * 1'000'000>;
+#else
+    using rep = TickType_t;
+    using period = std::ratio<1, configTICK_RATE_HZ>;
+#endif
+    using duration = std::chrono::duration<rep, period>;
+    using time_point = std::chrono::time_point<CycleClock>;
+
+    // The counter wraps around.
+    static constexpr bool is_steady = false;
+
+    static time_point now() noexcept {
+#if ESP_PLATFORM
+        return time_point { duration { esp_cpu_get_cycle_count() } };
+#else
+        return time_point { duration { xTaskGetTickCountFromISR() } };
+#endif
+    }
+};
+
+/// Execution time statistics of a piece of code that runs repeatedly.
+struct Timing {
+    /// Adds a new sample to the statistics.
+    void record(CycleClock::duration duration) {
+        ++count;
+        last = duration;
+        total += duration;
+        if (duration > max)
+            max = duration;
+    }
+
+    /// The average duration of every recorded sample.
+    [[nodiscard]] CycleClock::duration average() const {
+        return count == 0 ? CycleClock::duration::zero() : std::chrono::duration_cast<CycleClock::duration>(total / count);
+    }
+
+    uint32_t count { 0 };
+    CycleClock::duration last { 0 };
+    CycleClock::duration max { 0 };
+    // 64 bits wide so that it doesn't wrap around like the clock itself.
+    std::chrono::duration<uint64_t, CycleClock::period> total { 0 };
+};
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "CycleClock.hpp"
+
+namespace xf::time {
+
+/// A lock-free histogram of `CycleClock` durations, bucketed by powers of two.
+/// Bucket `0` counts durations of zero cycles and bucket `i` counts durations in the range `[2^(i-1), 2^i)`.
+/// Every method can be called concurrently from tasks and ISRs, on every core.
+class Histogram {
+public:
+    static constexpr size_t BUCKETS = std::numeric_limits<CycleClock::rep>::digits + 1;
+
+    /// Adds a new sample to the histogram.
+    void record(CycleClock::duration duration) {
+        m_buckets[std::bit_width(duration.count())].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// Obtains the amount of samples in the given bucket.
+    [[nodiscard]] uint32_t bucket(size_t index) const {
+        return m_buckets[index].load(std::memory_order_relaxed);
+    }
+
+    /// Obtains the amount of samples in every bucket.
+    [[nodiscard]] uint32_t samples() const {
+        uint32_t samples = 0;
+        for (const auto& bucket : m_buckets)
+            samples += bucket.load(std::memory_order_relaxed);
+        return samples;
+    }
+
+    /// Obtains the largest duration that falls in the given bucket.
+    [[nodiscard]] static constexpr CycleClock::duration upper_bound(size_t index) {
+        return CycleClock::duration { index == 0 ? 0 : static_cast<CycleClock::rep>((uint64_t(1) << index) - 1) };
+    }
+
+    /// Obtains an upper bound to the duration below which the given fraction of samples (between `0` and `1`) fall, e.g: `percentile(0.99f)`.
+    [[nodiscard]] CycleClock::duration percentile(float fraction) const {
+        const auto target = static_cast<uint32_t>(fraction * samples());
+        uint32_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            seen += bucket(i);
+            if (seen > target)
+                return upper_bound(i);
+        }
+        return upper_bound(BUCKETS - 1);
+    }
+
+    /// Discards every sample.
+    void reset() {
+        for (auto& bucket : m_buckets)
+            bucket.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::array<std::atomic<uint32_t>, BUCKETS> m_buckets {};
+};
+
+}
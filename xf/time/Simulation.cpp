@@ -0,0 +1,58 @@
+#include "Simulation.hpp"
+
+#if XF_TIME_SIMULATION
+
+#    include <atomic>
+#    include <type_traits>
+
+#    include <freertos/task.h>
+
+namespace {
+
+std::atomic<bool> s_auto_advance { true };
+std::atomic<uint32_t> s_jumps { 0 };
+std::atomic<uint64_t> s_skipped { 0 };
+
+}
+
+// Called by the idle task with the scheduler suspended, `expected_idle_ticks` being exactly how far away the next unblock time is.
+extern "C" void xf_time_simulation_idle(TickType_t expected_idle_ticks) {
+    // Every task is blocked indefinitely: only an interrupt can make progress, so there is nothing to jump to.
+    // The kernel then reports the ticks left until `portMAX_DELAY`, which can be anything depending on the current tick count.
+    if (not s_auto_advance.load(std::memory_order_relaxed) or static_cast<TickType_t>(xTaskGetTickCount() + expected_idle_ticks) == portMAX_DELAY)
+        return;
+
+    // Jumping right onto the next unblock time relies on FreeRTOS V10.5.0 or later, which pends that last tick instead of asserting.
+    vTaskStepTick(expected_idle_ticks);
+    s_jumps.fetch_add(1, std::memory_order_relaxed);
+    s_skipped.fetch_add(expected_idle_ticks, std::memory_order_relaxed);
+}
+
+namespace xf::time::simulation {
+
+void advance_to(Tick tick) {
+    // Unsigned tick arithmetic, read as signed, stays right across tick count overflows.
+    const TickType_t ahead = (tick - Clock::now()).count();
+    if (static_cast<std::make_signed_t<TickType_t>>(ahead) > 0)
+        detail::advance(ahead);
+}
+
+void set_auto_advance(bool enabled) {
+    s_auto_advance.store(enabled, std::memory_order_relaxed);
+}
+
+Stats stats() {
+    return Stats { s_jumps.load(std::memory_order_relaxed), s_skipped.load(std::memory_order_relaxed) };
+}
+
+void detail::advance(TickType_t ticks) {
+    if (ticks == 0)
+        return;
+
+    (void)xTaskCatchUpTicks(ticks);
+    s_skipped.fetch_add(ticks, std::memory_order_relaxed);
+}
+
+}
+
+#endif
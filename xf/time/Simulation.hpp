@@ -0,0 +1,60 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include <freertos/FreeRTOS.h>
+
+#include "time.hpp"
+#include <xf/config.hpp>
+
+//! A virtual-time backend for tests, enabled by `XF_TIME_SIMULATION`.
+//! Every xf timeout, `Task::delay()`, `Task::every()` and `Timer` is expressed in FreeRTOS ticks, so instead of patching each of them the simulation makes the tick count itself virtual: whenever every task is blocked, the idle task jumps the tick count straight to the next tick some task or timer is waiting for.
+//! An hour-long retry scenario thus runs as fast as the CPU can execute it, and always in the same order.
+//! This is done through the kernel's tickless idle hook, which must be pointed at the simulation in `FreeRTOSConfig.h`:
+//! ```c
+//! #define configUSE_TICKLESS_IDLE 1
+//! #define configEXPECTED_IDLE_TIME_BEFORE_SLEEP 2
+//! extern void xf_time_simulation_idle(TickType_t expected_idle_ticks);
+//! #define portSUPPRESS_TICKS_AND_SLEEP(expected_idle_ticks) xf_time_simulation_idle(expected_idle_ticks)
+//! ```
+//! The real tick interrupt keeps running on top of the jumps, so `time::Clock` stays monotonic. `CycleClock` is not affected by the simulation.
+
+extern "C" void xf_time_simulation_idle(TickType_t expected_idle_ticks);
+
+namespace xf::time::simulation {
+
+/// Statistics of the jumps performed by the simulation.
+struct Stats {
+    /// How many times the tick count jumped forward.
+    uint32_t jumps;
+    /// How many ticks were skipped in total, by jumps and calls to `advance()`.
+    uint64_t skipped;
+};
+
+/// Moves the tick count forward by the given amount of time, unblocking and running every task and timer whose timeout expires in the meantime, as if the time had actually passed.
+/// Must only be called from a task.
+/// Refer to the module-level `time` documentation to see how time is converted to FreeRTOS ticks.
+template<typename Rep, typename Period>
+void advance(std::chrono::duration<Rep, Period>);
+
+/// Moves the tick count forward to the given tick, if it is still in the future. Must only be called from a task.
+void advance_to(Tick);
+
+/// Enables or disables jumping forward when every task is blocked. Enabled by default.
+/// Disabling it lets a test drive time exclusively through `advance()`.
+void set_auto_advance(bool);
+
+/// Obtains the statistics of the jumps performed so far.
+[[nodiscard]] Stats stats();
+
+namespace detail {
+void advance(TickType_t ticks);
+}
+
+template<typename Rep, typename Period>
+void advance(std::chrono::duration<Rep, Period> duration) {
+    detail::advance(to_raw_tick(duration));
+}
+
+}
@@ -0,0 +1,105 @@
+#include "TimerCore.hpp"
+
+namespace xf::timer {
+
+TimerCore::TimerCore(Mode mode, Invoke invoke)
+    : m_mode(mode)
+    , m_invoke(invoke) {
+}
+
+TimerCore::~TimerCore() {
+    if (m_handle)
+        await_destroy();
+}
+
+TimerCore::TimerCore(TimerCore&& other) noexcept
+    : m_mode(other.m_mode)
+    , m_invoke(other.m_invoke) {
+    configASSERT(other.m_handle == nullptr);
+}
+
+TimerCore& TimerCore::operator=(TimerCore&& other) noexcept {
+    if (this != &other) {
+        configASSERT(other.m_handle == nullptr);
+        if (m_handle)
+            await_destroy();
+        m_mode = other.m_mode;
+        m_invoke = other.m_invoke;
+    }
+    return *this;
+}
+
+bool TimerCore::is_active() const {
+    return xTimerIsTimerActive(m_handle) != pdFALSE;
+}
+
+void TimerCore::await_start() {
+    (void)start(time::FOREVER);
+}
+
+void TimerCore::await_stop() {
+    (void)stop(time::FOREVER);
+}
+
+void TimerCore::await_destroy() {
+    (void)destroy(time::FOREVER);
+}
+
+void TimerCore::await_reset() {
+    (void)reset(time::FOREVER);
+}
+
+Handle TimerCore::raw_handle() const {
+    return m_handle;
+}
+
+isr::Timer TimerCore::for_isr() {
+    return isr::Timer { m_handle };
+}
+
+void TimerCore::create_raw(const char* name, TickType_t period) {
+    configASSERT(m_handle == nullptr);
+    m_handle = xTimerCreateStatic(
+        name,
+        period,
+        m_mode == Mode::Repeating,
+        this,
+        &TimerCore::callback,
+        &m_static_timer);
+}
+
+bool TimerCore::start_raw(TickType_t timeout) {
+    return xTimerStart(m_handle, timeout) == pdTRUE;
+}
+
+bool TimerCore::stop_raw(TickType_t timeout) {
+    return xTimerStop(m_handle, timeout) == pdTRUE;
+}
+
+bool TimerCore::change_period_raw(TickType_t period, TickType_t timeout) {
+    return xTimerChangePeriod(m_handle, period, timeout) == pdTRUE;
+}
+
+bool TimerCore::destroy_raw(TickType_t timeout) {
+    if (xTimerDelete(m_handle, timeout) == pdTRUE) {
+        m_handle = nullptr;
+        return true;
+    } else {
+        return false;
+    }
+}
+
+bool TimerCore::reset_raw(TickType_t timeout) {
+    return xTimerReset(m_handle, timeout) == pdTRUE;
+}
+
+void TimerCore::callback(TimerHandle_t handle) {
+    auto& self = *static_cast<TimerCore*>(pvTimerGetTimerID(handle));
+
+    self.m_invoke(self);
+
+    if (self.m_mode == Mode::SelfDestructive)
+        self.await_destroy();
+}
+
+}
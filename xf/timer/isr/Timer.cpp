@@ -0,0 +1,41 @@
+#include "Timer.hpp"
+
+namespace xf::timer::isr {
+
+Timer::Timer(TimerHandle_t handle)
+    : m_handle(handle) {
+}
+
+std::optional<xf::isr::HigherPriorityTaskWoken> Timer::start() {
+    BaseType_t higher_priority_task_woken = false;
+    if (xTimerStartFromISR(m_handle, &higher_priority_task_woken) == pdFAIL)
+        return std::nullopt;
+
+    return higher_priority_task_woken;
+}
+
+std::optional<xf::isr::HigherPriorityTaskWoken> Timer::stop() {
+    BaseType_t higher_priority_task_woken = false;
+    if (xTimerStopFromISR(m_handle, &higher_priority_task_woken) == pdFAIL)
+        return std::nullopt;
+
+    return higher_priority_task_woken;
+}
+
+std::optional<xf::isr::HigherPriorityTaskWoken> Timer::reset() {
+    BaseType_t higher_priority_task_woken = false;
+    if (xTimerResetFromISR(m_handle, &higher_priority_task_woken) == pdFAIL)
+        return std::nullopt;
+
+    return higher_priority_task_woken;
+}
+
+std::optional<xf::isr::HigherPriorityTaskWoken> Timer::change_period_raw(TickType_t period) {
+    BaseType_t higher_priority_task_woken = false;
+    if (xTimerChangePeriodFromISR(m_handle, period, &higher_priority_task_woken) == pdFAIL)
+        return std::nullopt;
+
+    return higher_priority_task_woken;
+}
+
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <optional>
 
 #include <freertos/FreeRTOS.h>
@@ -10,8 +11,8 @@
 
 namespace xf::timer::isr {
 
-/// An ISR-safe version of `Timer`, obtained by calling `Timer::to_isr()`.
-template<typename... Ctx>
+/// An ISR-safe version of `TimerCore`, obtained by calling `TimerCore::for_isr()`.
+/// It is shared by every timer type since it only operates on the timer's handle.
 class Timer {
 public:
     /// Constructs a new ISR-safe timer from the given handle.
@@ -35,49 +36,14 @@ public:
     [[nodiscard]] std::optional<xf::isr::HigherPriorityTaskWoken> reset();
 
 private:
+    [[nodiscard]] std::optional<xf::isr::HigherPriorityTaskWoken> change_period_raw(TickType_t period);
+
     TimerHandle_t m_handle { nullptr };
 };
 
-template<typename... Ctx>
-Timer<Ctx...>::Timer(TimerHandle_t handle)
-    : m_handle(handle) {
-}
-
-template<typename... Ctx>
-std::optional<xf::isr::HigherPriorityTaskWoken> Timer<Ctx...>::start() {
-    BaseType_t higher_priority_task_woken = false;
-    if (xTimerStartFromISR(m_handle, &higher_priority_task_woken) == pdFAIL)
-        return std::nullopt;
-
-    return higher_priority_task_woken;
-}
-
-template<typename... Ctx>
-std::optional<xf::isr::HigherPriorityTaskWoken> Timer<Ctx...>::stop() {
-    BaseType_t higher_priority_task_woken = false;
-    if (xTimerStopFromISR(m_handle, &higher_priority_task_woken) == pdFAIL)
-        return std::nullopt;
-
-    return higher_priority_task_woken;
-}
-
-template<typename... Ctx>
 template<typename Rep, typename Period>
-std::optional<xf::isr::HigherPriorityTaskWoken> Timer<Ctx...>::change_period(std::chrono::duration<Rep, Period> period) {
-    BaseType_t higher_priority_task_woken = false;
-    if (xTimerChangePeriodFromISR(m_handle, time::to_raw_tick(period), time::to_raw_tick(period)) == pdFAIL)
-        return std::nullopt;
-
-    return higher_priority_task_woken;
-}
-
-template<typename... Ctx>
-std::optional<xf::isr::HigherPriorityTaskWoken> Timer<Ctx...>::reset() {
-    BaseType_t higher_priority_task_woken = false;
-    if (xTimerResetFromISR(m_handle, &higher_priority_task_woken) == pdFAIL)
-        return std::nullopt;
-
-    return higher_priority_task_woken;
+std::optional<xf::isr::HigherPriorityTaskWoken> Timer::change_period(std::chrono::duration<Rep, Period> period) {
+    return change_period_raw(time::to_raw_tick(period));
 }
 
 }